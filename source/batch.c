@@ -0,0 +1,221 @@
+#include "batch.h"
+
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <threads.h>
+
+
+// positions taken by a thread at once - fewer shared counter updates
+static const uint32_t POSITIONS_PER_TAKE = 64;
+
+
+// positions shared by every thread of a batch
+typedef struct
+{
+    const position_t *positions;
+    uint32_t count;
+    const limits_t *limits;
+    result_t *results;
+
+    // index of the next position to take
+    atomic_uint_fast32_t next;
+} batch_t;
+
+// thread of a batch
+typedef struct
+{
+    thrd_t thread;
+    bool isStarted;
+    batch_t *batch;
+} worker_t;
+
+
+static int runBatch(void *worker);
+static void solvePosition(const position_t *position,
+                          const limits_t   *limits,
+                          boardstorage_t   *storage,
+                          board_t         **board,
+                          result_t         *result);
+
+
+/* ------------------------------ START PUBLIC ------------------------------ */
+
+
+/*
+@context
+    * Finds the best move and its score of every position within `positions`.
+    * Positions are split between `threads` threads.
+    * Positions are searched to the end of every game when `limits` is `NULL`
+      (same as `getBestMoveScore`), otherwise within `limits` for each
+      position (same as `getBestMoveLimited`).
+
+@parameters
+    * positions
+        * Positions to find the best move of (for the symbol to move).
+    * count
+        * Number of `positions`.
+    * limits
+        * Most states, time and depth to search each position.
+        * `NULL` searches each position to the end of every game.
+    * threads
+        * Number of threads to search with.
+        * `0` and `1` search without starting a thread.
+    * results
+        * Filled with the best move and score of each of `positions`.
+        * Move is `RESULT_MOVE_NONE` (score `0`) if a position already ended.
+*/
+void getBestMoves(const position_t  positions[],
+                  uint32_t          count,
+                  const limits_t   *limits,
+                  uint8_t           threads,
+                  result_t          results[])
+{
+    batch_t batch;
+    worker_t *workers;
+    worker_t worker;
+    uint8_t i;
+
+    batch.positions = positions;
+    batch.count = count;
+    batch.limits = limits;
+    batch.results = results;
+    atomic_init(&batch.next, 0);
+
+    worker.batch = &batch;
+    if (threads <= 1)
+    {
+        runBatch(&worker);
+        return;
+    }
+
+    workers = malloc(sizeof(worker_t) * threads);
+    assert(workers != NULL);
+
+    // positions of a thread which fails to start are taken by the others
+    for (i = 1; i < threads; i += 1)
+    {
+        workers[i].batch = &batch;
+        workers[i].isStarted = thrd_create(&workers[i].thread,
+                                           runBatch,
+                                           &workers[i]) == thrd_success;
+    }
+    runBatch(&worker);
+
+    for (i = 1; i < threads; i += 1)
+    {
+        if (workers[i].isStarted)
+        {
+            thrd_join(workers[i].thread, NULL);
+        }
+    }
+
+    free(workers);
+}
+
+
+/* ------------------------------- END PUBLIC ------------------------------- */
+/* ----------------------------- START  PRIVATE ----------------------------- */
+
+
+/*
+@context
+    * Solves positions of a batch until none are left.
+    * Run by every thread of the batch.
+
+@parameters
+    * worker
+        * Thread solving the positions.
+
+@return
+    * Always `0` (required by `thrd_create`).
+*/
+static int runBatch(void *worker)
+{
+    batch_t *batch;
+    boardstorage_t storage;
+    board_t *board;
+    uint32_t first, last, i;
+
+    batch = ((worker_t *)worker)->batch;
+    board = NULL;
+
+    while ((first = atomic_fetch_add(&batch->next, POSITIONS_PER_TAKE))
+           < batch->count)
+    {
+        last = first + POSITIONS_PER_TAKE;
+        if (last > batch->count)
+        {
+            last = batch->count;
+        }
+
+        for (i = first; i < last; i += 1)
+        {
+            solvePosition(&batch->positions[i],
+                          batch->limits,
+                          &storage,
+                          &board,
+                          &batch->results[i]);
+        }
+    }
+
+    return 0;
+}
+
+
+/*
+@context
+    * Finds the best move and its score of `position`.
+
+@parameters
+    * position
+        * Position to solve.
+    * limits
+        * Most states, time and depth to search.
+        * `NULL` searches to the end of every game.
+    * storage
+        * Memory of the board of the thread.
+    * board
+        * Board of the thread (within `storage`) to decode `position` into.
+        * Initialised again if `NULL` or a different size or win length.
+    * result
+        * Set to the best move and score of `position`.
+*/
+static void solvePosition(const position_t *position,
+                          const limits_t   *limits,
+                          boardstorage_t   *storage,
+                          board_t         **board,
+                          result_t         *result)
+{
+    if (*board == NULL || getSize(*board) != position->size
+        || getLength(*board) != position->length)
+    {
+        *board = initBoardStorage(storage, position->size, position->length);
+    }
+
+    decodePosition(position, *board);
+
+    // ended positions have no move to make
+    if (isWin(*board, NOUGHT) || isWin(*board, CROSS) || isFull(*board))
+    {
+        result->move = RESULT_MOVE_NONE;
+        result->score = 0;
+    }
+    else if (limits == NULL)
+    {
+        result->move = getBestMoveScore(*board,
+                                        position->symbol,
+                                        &result->score);
+    }
+    else
+    {
+        result->move = getBestMoveLimited(*board,
+                                          position->symbol,
+                                          limits,
+                                          &result->score);
+    }
+}
+
+
+/* ------------------------------ END  PRIVATE ------------------------------ */
@@ -0,0 +1,38 @@
+/*
+@context
+    * Provides a method to find the best move of many positions in 1 call.
+    * Positions are split between threads which each decode them into their
+      own board - kept within the thread's stack so no board is allocated.
+    * Every position shares the transposition table (`initMinimax`) and the
+      opening book.
+*/
+
+
+#ifndef _BATCH_H
+    #define _BATCH_H
+
+    #include <stdint.h>
+
+    #include "minimax.h"
+    #include "position.h"
+    #include "score.h"
+
+
+    // move of positions which have already ended
+    static const uint8_t RESULT_MOVE_NONE = UINT8_MAX;
+
+
+    typedef struct
+    {
+        uint8_t move;
+        score_t score;
+    } result_t;
+
+
+    void getBestMoves(const position_t  positions[],
+                      uint32_t          count,
+                      const limits_t   *limits,
+                      uint8_t           threads,
+                      result_t          results[]);
+
+#endif
@@ -0,0 +1,473 @@
+/*
+@context
+    * Benchmarks the engine without the interface (no terminal needed).
+    * Solves standard suites of positions and prints a line of JSON for each
+      suite with states per second, moves per second and move latencies.
+        * `empty` - empty 3x3 and 4x4 boards searched to the end of every game.
+        * `3x3` - every reachable 3x3 state which has not ended.
+        * `4x4` - fixed 4x4 states searched to the end of every game.
+        * `k-in-a-row` - fixed states of larger boards searched to a depth.
+    * Built and run with `make bench` (`./benchmark [suite ...]` for only some).
+    * Built without the opening book so 3x3 states are searched, and with
+      `SEARCH_STATS` so states searched can be counted.
+    * Each suite starts with an empty transposition table and is searched by
+      1 thread so results can be compared between versions.
+*/
+
+
+#include <assert.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "board.h"
+#include "minimax.h"
+#include "position.h"
+#include "stats.h"
+#include "timer.h"
+
+
+// entries of the transposition table of each suite
+static const uint32_t TABLE_SIZE = 1 << 20;
+
+// states of a 3x3 board - each cell empty, nought or cross
+#define REACHABLE_STATES 19683
+
+static const double NS_PER_S = 1e9;
+
+
+// position of a suite - moves are cells placed in turn (noughts first)
+typedef struct
+{
+    const char *suite;
+    uint8_t size;
+    uint8_t length;
+    uint8_t depth; // `0` searches to the end of every game
+    const char *moves; // `NULL` for every reachable 3x3 state
+} benchposition_t;
+
+// position to solve and its depth limit
+typedef struct
+{
+    position_t position;
+    uint8_t depth;
+} task_t;
+
+
+static const char *SUITES[] = {"empty", "3x3", "4x4", "k-in-a-row"};
+
+static const benchposition_t POSITIONS[] =
+{
+    {"empty", 3, 3, 0, ""},
+    {"empty", 4, 4, 0, ""},
+
+    {"3x3", 3, 3, 0, NULL},
+
+    {"4x4", 4, 4, 0, "5"},
+    {"4x4", 4, 4, 0, "0 5"},
+    {"4x4", 4, 4, 0, "5 10 6"},
+    {"4x4", 4, 3, 0, ""},
+    {"4x4", 4, 3, 0, "5 6"},
+
+    {"k-in-a-row", 7, 4, 6, "24"},
+    {"k-in-a-row", 9, 5, 5, "40 41"},
+    {"k-in-a-row", 15, 5, 4, "112 113 97"},
+};
+
+
+static void runSuite(const char *suite);
+static uint32_t addTasks(const benchposition_t *benchPosition,
+                         task_t                *tasks,
+                         uint32_t               count);
+static uint32_t addReachable(board_t *board,
+                             char     symbol,
+                             uint8_t  depth,
+                             bool    *isVisited,
+                             task_t  *tasks,
+                             uint32_t count);
+static uint64_t solveTask(const task_t   *task,
+                          boardstorage_t *storage,
+                          board_t       **board);
+static int compareTimes(const void *a,
+                        const void *b);
+static double getPercentile(const uint64_t *times,
+                            uint32_t        count,
+                            uint8_t         percentile);
+static bool isEnded(board_t *board);
+
+
+/*
+@context
+    * Entry point of program.
+    * Runs every suite named by the arguments (every suite if none named).
+
+@parameters
+    * argc
+        * Number of arguments.
+    * argv
+        * Name of the program then the names of the suites to run.
+
+@return
+    * Indicates program successfully terminates.
+    * Fails if a suite named does not exist.
+*/
+int main(int   argc,
+         char *argv[])
+{
+    uint8_t count, i;
+    int arg;
+
+    count = sizeof(SUITES) / sizeof(SUITES[0]);
+
+    for (arg = 1; arg < argc; arg += 1)
+    {
+        for (i = 0; i < count && strcmp(argv[arg], SUITES[i]) != 0; i += 1);
+        if (i == count)
+        {
+            fprintf(stderr, "unknown suite: %s\n", argv[arg]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    for (i = 0; i < count; i += 1)
+    {
+        for (arg = 1; arg < argc && strcmp(argv[arg], SUITES[i]) != 0;
+             arg += 1);
+        if (argc == 1 || arg < argc)
+        {
+            runSuite(SUITES[i]);
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+/*
+@context
+    * Solves every position of `suite` and prints its results.
+
+@parameters
+    * suite
+        * Name of the suite to run.
+*/
+static void runSuite(const char *suite)
+{
+    task_t *tasks;
+    uint64_t *times, nodes, total;
+    uint32_t count, i;
+    boardstorage_t storage;
+    board_t *board;
+    stats_t stats;
+    double seconds;
+
+    // reachable states dominate every other suite
+    tasks = malloc(sizeof(task_t) * REACHABLE_STATES);
+    assert(tasks != NULL);
+
+    count = 0;
+    for (i = 0; i < sizeof(POSITIONS) / sizeof(POSITIONS[0]); i += 1)
+    {
+        if (strcmp(POSITIONS[i].suite, suite) == 0)
+        {
+            count = addTasks(&POSITIONS[i], tasks, count);
+        }
+    }
+
+    times = malloc(sizeof(uint64_t) * count);
+    assert(times != NULL);
+
+    initMinimax(TABLE_SIZE);
+    setStats(&stats);
+    board = NULL;
+
+    nodes = 0;
+    total = 0;
+    for (i = 0; i < count; i += 1)
+    {
+        clearStats(&stats);
+        times[i] = solveTask(&tasks[i], &storage, &board);
+        nodes += getTotalNodes(&stats);
+        total += times[i];
+    }
+
+    setStats(NULL);
+    freeMinimax();
+
+    qsort(times, count, sizeof(uint64_t), compareTimes);
+    seconds = total / NS_PER_S;
+
+    printf("{\"suite\": \"%s\", \"positions\": %u, \"nodes\": %" PRIu64 ", "
+           "\"seconds\": %.6f, \"nodes_per_sec\": %.0f, "
+           "\"moves_per_sec\": %.1f, \"p50_ms\": %.3f, \"p90_ms\": %.3f, "
+           "\"p99_ms\": %.3f, \"max_ms\": %.3f}\n",
+           suite, count, nodes, seconds,
+           seconds > 0 ? nodes / seconds : 0,
+           seconds > 0 ? count / seconds : 0,
+           getPercentile(times, count, 50),
+           getPercentile(times, count, 90),
+           getPercentile(times, count, 99),
+           getPercentile(times, count, 100));
+    fflush(stdout);
+
+    free(times);
+    free(tasks);
+}
+
+
+/*
+@context
+    * Adds the tasks of `benchPosition` after the first `count` of `tasks`.
+
+@parameters
+    * benchPosition
+        * Position of a suite to add.
+    * tasks
+        * Tasks of the suite.
+    * count
+        * Number of `tasks` already added.
+
+@return
+    * Number of `tasks` including those added.
+*/
+static uint32_t addTasks(const benchposition_t *benchPosition,
+                         task_t                *tasks,
+                         uint32_t               count)
+{
+    boardstorage_t storage;
+    board_t *board;
+    bool *isVisited;
+    const char *moves;
+    char *end, symbol;
+    long move;
+
+    board = initBoardStorage(&storage,
+                             benchPosition->size,
+                             benchPosition->length);
+
+    if (benchPosition->moves == NULL)
+    {
+        assert(benchPosition->size == 3);
+
+        isVisited = calloc(REACHABLE_STATES, sizeof(bool));
+        assert(isVisited != NULL);
+
+        count = addReachable(board,
+                             NOUGHT,
+                             benchPosition->depth,
+                             isVisited,
+                             tasks,
+                             count);
+
+        free(isVisited);
+        return count;
+    }
+
+    symbol = NOUGHT;
+    moves = benchPosition->moves;
+    while ((move = strtol(moves, &end, 10)), end != moves)
+    {
+        assert(isValidMove(board, move, symbol));
+        setCell(board, move, symbol);
+        symbol = symbol == NOUGHT ? CROSS : NOUGHT;
+        moves = end;
+    }
+    assert(!isEnded(board));
+
+    encodePosition(board, symbol, &tasks[count].position);
+    tasks[count].depth = benchPosition->depth;
+
+    return count + 1;
+}
+
+
+/*
+@context
+    * Adds every state reachable from `board` which has not ended (including
+      `board`) after the first `count` of `tasks`.
+    * States reached by different move orders are only added once.
+
+@parameters
+    * board
+        * 3x3 board of the state to add the reachable states of.
+    * symbol
+        * Symbol to move next.
+    * depth
+        * Depth limit of each task.
+    * isVisited
+        * Whether each state (by `getPositionIndex`) has already been added.
+    * tasks
+        * Tasks of the suite.
+    * count
+        * Number of `tasks` already added.
+
+@return
+    * Number of `tasks` including those added.
+*/
+static uint32_t addReachable(board_t *board,
+                             char     symbol,
+                             uint8_t  depth,
+                             bool    *isVisited,
+                             task_t  *tasks,
+                             uint32_t count)
+{
+    position_t position;
+    uint64_t index;
+    uint8_t move;
+
+    encodePosition(board, symbol, &position);
+    index = getPositionIndex(&position);
+    if (isVisited[index] || isEnded(board))
+    {
+        return count;
+    }
+    isVisited[index] = true;
+
+    tasks[count].position = position;
+    tasks[count].depth = depth;
+    count += 1;
+
+    for (move = 0; move < 9; move += 1)
+    {
+        if (isValidMove(board, move, symbol))
+        {
+            makeMove(board, move, symbol);
+            count = addReachable(board,
+                                 symbol == NOUGHT ? CROSS : NOUGHT,
+                                 depth,
+                                 isVisited,
+                                 tasks,
+                                 count);
+            unmakeMove(board);
+        }
+    }
+
+    return count;
+}
+
+
+/*
+@context
+    * Finds the best move of the position of `task`.
+
+@parameters
+    * task
+        * Position to solve and its depth limit.
+    * storage
+        * Memory of the board to decode the position into.
+    * board
+        * Board (within `storage`) to decode the position into.
+        * Initialised again if `NULL` or a different size or win length.
+
+@return
+    * Nanoseconds taken to find the best move.
+*/
+static uint64_t solveTask(const task_t   *task,
+                          boardstorage_t *storage,
+                          board_t       **board)
+{
+    const position_t *position;
+    limits_t limits;
+    uint64_t start;
+    score_t score;
+
+    position = &task->position;
+    if (*board == NULL || getSize(*board) != position->size
+        || getLength(*board) != position->length)
+    {
+        *board = initBoardStorage(storage, position->size, position->length);
+    }
+    decodePosition(position, *board);
+
+    limits.nodes = 0;
+    limits.time = 0;
+    limits.depth = task->depth;
+
+    start = getTime();
+    if (task->depth == 0)
+    {
+        getBestMoveScore(*board, position->symbol, &score);
+    }
+    else
+    {
+        getBestMoveLimited(*board, position->symbol, &limits, &score);
+    }
+
+    return getTime() - start;
+}
+
+
+/*
+@context
+    * Compares 2 times for `qsort` (ascending).
+
+@parameters
+    * a
+        * First time.
+    * b
+        * Second time.
+
+@return
+    * Negative, `0` or positive if `a` is less, equal or greater than `b`.
+*/
+static int compareTimes(const void *a,
+                        const void *b)
+{
+    uint64_t timeA, timeB;
+
+    timeA = *(const uint64_t *)a;
+    timeB = *(const uint64_t *)b;
+
+    return (timeA > timeB) - (timeA < timeB);
+}
+
+
+/*
+@context
+    * Gets the time at `percentile` of `times` (nearest rank).
+
+@parameters
+    * times
+        * Times in nanoseconds sorted ascending.
+    * count
+        * Number of `times`.
+    * percentile
+        * Percent of times at or below the time to get (`1` to `100`).
+
+@return
+    * Time at `percentile` in milliseconds (`0` if there are no times).
+*/
+static double getPercentile(const uint64_t *times,
+                            uint32_t        count,
+                            uint8_t         percentile)
+{
+    uint32_t rank;
+
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    rank = ((count * percentile) + 99) / 100;
+    return times[rank > 0 ? rank - 1 : 0] / (double)NS_PER_MS;
+}
+
+
+/*
+@context
+    * Determines if the game of `board` has ended.
+
+@parameters
+    * board
+        * Board to check.
+
+@return
+    * Whether a symbol has won or every cell is filled.
+*/
+static bool isEnded(board_t *board)
+{
+    return isWin(board, NOUGHT) || isWin(board, CROSS) || isFull(board);
+}
@@ -0,0 +1,216 @@
+/*
+@context
+    * Provides a fixed size set of board cells stored as bits.
+    * Cells are organised row-wise with `BITBOARD_STRIDE` bits per row.
+        * The bits at the end of each row past the board width are always
+          unset, so shifting a bitboard never moves a cell into another row.
+    * All operations are inline as they are used at every node of a search.
+*/
+
+
+#ifndef _BITBOARD_H
+    #define _BITBOARD_H
+
+    #include <stdbool.h>
+    #include <stdint.h>
+
+
+    // bits per row and 64-bit words per bitboard (16 rows of 16 bits)
+    #define BITBOARD_STRIDE 16
+    #define BITBOARD_WORDS 4
+
+
+    typedef struct
+    {
+        uint64_t words[BITBOARD_WORDS];
+    } bitboard_t;
+
+
+    /*
+    @context
+        * Gets the bit of the cell at `row` and `column`.
+
+    @parameters
+        * row
+            * Row of the cell.
+        * column
+            * Column of the cell.
+
+    @return
+        * Bit index of the cell within a bitboard.
+    */
+    static inline uint16_t getBit(uint8_t row,
+                                  uint8_t column)
+    {
+        return (row * BITBOARD_STRIDE) + column;
+    }
+
+
+    /*
+    @context
+        * Unsets every bit of `bitboard`.
+
+    @parameters
+        * bitboard
+            * Bitboard to clear.
+    */
+    static inline void clearBitboard(bitboard_t *bitboard)
+    {
+        uint8_t i;
+
+        for (i = 0; i < BITBOARD_WORDS; i += 1)
+        {
+            bitboard->words[i] = 0;
+        }
+    }
+
+
+    /*
+    @context
+        * Sets `bit` within `bitboard`.
+
+    @parameters
+        * bitboard
+            * Bitboard to set `bit` in.
+        * bit
+            * Bit to set.
+    */
+    static inline void setBit(bitboard_t *bitboard,
+                              uint16_t    bit)
+    {
+        bitboard->words[bit / 64] |= (uint64_t)1 << (bit % 64);
+    }
+
+
+    /*
+    @context
+        * Unsets `bit` within `bitboard`.
+
+    @parameters
+        * bitboard
+            * Bitboard to unset `bit` in.
+        * bit
+            * Bit to unset.
+    */
+    static inline void unsetBit(bitboard_t *bitboard,
+                                uint16_t    bit)
+    {
+        bitboard->words[bit / 64] &= ~((uint64_t)1 << (bit % 64));
+    }
+
+
+    /*
+    @context
+        * Determines if `bit` is set within `bitboard`.
+
+    @parameters
+        * bitboard
+            * Bitboard to check.
+        * bit
+            * Bit to check.
+
+    @return
+        * Indicates if `bit` is set.
+    */
+    static inline bool isBitSet(const bitboard_t *bitboard,
+                                uint16_t          bit)
+    {
+        return (bitboard->words[bit / 64] >> (bit % 64)) & 1;
+    }
+
+
+    /*
+    @context
+        * Determines if every bit of `mask` is also set within `bitboard`.
+
+    @parameters
+        * bitboard
+            * Bitboard to check.
+        * mask
+            * Bits that must all be set.
+
+    @return
+        * Indicates if `mask` is a subset of `bitboard`.
+    */
+    static inline bool isSubset(const bitboard_t *bitboard,
+                                const bitboard_t *mask)
+    {
+        uint64_t missing;
+        uint8_t i;
+
+        missing = 0;
+        for (i = 0; i < BITBOARD_WORDS; i += 1)
+        {
+            missing |= mask->words[i] & ~bitboard->words[i];
+        }
+        return missing == 0;
+    }
+
+
+    /*
+    @context
+        * Determines if no bit of `bitboard` is set.
+
+    @parameters
+        * bitboard
+            * Bitboard to check.
+
+    @return
+        * Indicates if `bitboard` is empty.
+    */
+    static inline bool isBitboardEmpty(const bitboard_t *bitboard)
+    {
+        uint64_t bits;
+        uint8_t i;
+
+        bits = 0;
+        for (i = 0; i < BITBOARD_WORDS; i += 1)
+        {
+            bits |= bitboard->words[i];
+        }
+        return bits == 0;
+    }
+
+
+    /*
+    @context
+        * Grows `bitboard` by 1 cell in every direction (including diagonals).
+        * Bits shifted past the end of a row (or the board) are removed by
+          `mask` so every row stays independent.
+
+    @parameters
+        * bitboard
+            * Bitboard to grow.
+        * mask
+            * Bits of every cell of the board.
+    */
+    static inline void dilateBitboard(bitboard_t       *bitboard,
+                                      const bitboard_t *mask)
+    {
+        uint64_t rows[BITBOARD_WORDS], *words;
+        uint8_t i;
+
+        words = bitboard->words;
+
+        // left and right - bits carried between words are in the same row
+        for (i = 0; i < BITBOARD_WORDS; i += 1)
+        {
+            rows[i] = words[i] | (words[i] << 1) | (words[i] >> 1)
+                | (i > 0 ? words[i - 1] >> 63 : 0)
+                | (i + 1 < BITBOARD_WORDS ? words[i + 1] << 63 : 0);
+        }
+
+        // up and down - a row above or below can be within the next word
+        for (i = 0; i < BITBOARD_WORDS; i += 1)
+        {
+            words[i] = rows[i] | (rows[i] << BITBOARD_STRIDE)
+                | (rows[i] >> BITBOARD_STRIDE)
+                | (i > 0 ? rows[i - 1] >> (64 - BITBOARD_STRIDE) : 0)
+                | (i + 1 < BITBOARD_WORDS
+                   ? rows[i + 1] << (64 - BITBOARD_STRIDE)
+                   : 0);
+            words[i] &= mask->words[i];
+        }
+    }
+
+#endif
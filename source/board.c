@@ -2,26 +2,122 @@
 
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
+#include <threads.h>
+
+#include "bitboard.h"
+#include "lines.h"
+#include "symmetry.h"
+
+
+// windows are along rows, columns and both diagonals
+#define BOARD_DIRECTIONS 4
+
+#define BOARD_MAX_CELLS (BOARD_MAX_SIZE * BOARD_MAX_SIZE)
+#define BITBOARD_BITS (BITBOARD_WORDS * 64)
+
+// window of each direction starting at each cell (not every one is used)
+#define BOARD_MAX_WINDOWS (BOARD_DIRECTIONS * BOARD_MAX_CELLS)
+
+// threat weights stop growing past this many symbols so evaluations fit
+#define THREAT_MAX_SHIFT 20
+
+
+// row and column steps of each direction - right, down and both diagonals
+static const int8_t DIRECTION_ROWS[BOARD_DIRECTIONS] = {0, 1, 1, 1};
+static const int8_t DIRECTION_COLUMNS[BOARD_DIRECTIONS] = {1, 0, 1, -1};
 
 
 struct board_s
 {
     uint8_t size;
-    char *cells;
+    uint8_t length;
+
+    // windows each cell is part of (`BOARD_DIRECTIONS * length` per cell)
+    // shared by every board of the same size and length
+    const uint16_t *windows;
+    const uint8_t *windowCounts;
+
+    // cells occupied by each symbol (indexed by `getSymbolIndex`)
+    bitboard_t symbols[2];
+
+    // number of cells each symbol has within every window
+    uint8_t counts[2][BOARD_MAX_WINDOWS];
+
+    // number of windows each symbol has filled and number of non-empty cells
+    uint16_t wins[2];
+    uint8_t filled;
+
+    // number of windows only held by each symbol which are 1 cell from filled
+    uint16_t winsNext[2];
+
+    // sum of the threat weight of every window only held by each symbol
+    int32_t threats[2];
+
+    // Zobrist hash - XOR of the key of every symbol in every non-empty cell
+    // kept for the board transformed by each symmetry (indexed by symmetry)
+    uint64_t hashes[SYMMETRY_COUNT];
+
+    // instead of a 2D array a 1D array is used cells organised row-wise
+    char cells[BOARD_MAX_CELLS];
+
+    // cells of the moves made by `makeMove` (not yet unmade) in order
+    uint8_t moves[BOARD_MAX_CELLS];
+    uint8_t moveCount;
 };
 
+static_assert(sizeof(board_t) <= sizeof(boardstorage_t),
+              "BOARD_STORAGE_WORDS too small to hold a board");
+
+
+// bitboard bit of every cell under every symmetry for each board size
+static uint8_t symmetricBits
+    [BOARD_MAX_SIZE + 1][BOARD_MAX_CELLS][SYMMETRY_COUNT];
+
+// Zobrist key of each symbol (indexed by `getSymbolIndex`) at each bit
+static uint64_t zobristKeys[BITBOARD_BITS][2];
+
+// threat weight of a window only held by a symbol with each number of cells
+static int32_t threatWeights[BOARD_MAX_SIZE + 1];
+
+// bits of every cell of each board size
+static bitboard_t cellMasks[BOARD_MAX_SIZE + 1];
+
+// tables are shared by every board and filled once by `initTables`
+static once_flag tablesFlag = ONCE_FLAG_INIT;
 
-static bool isWinRow(board_t *board,
-                     uint8_t  row,
-                     char     symbol);
-static bool isWinCol(board_t *board,
-                     uint8_t  column,
-                     char     symbol);
+// windows of each size and length of board - found by the first board of each
+// (under `windowsLock`) and kept until the program ends
+static const uint16_t *windowTables[BOARD_MAX_SIZE + 1][BOARD_MAX_SIZE + 1];
+static const uint8_t *windowCountTables[BOARD_MAX_SIZE + 1][BOARD_MAX_SIZE + 1];
+static mtx_t windowsLock;
 
-static bool isWinForwardDiag(board_t *board,
-                             char     symbol);
-static bool isWinBackwardDiag(board_t *board,
-                              char     symbol);
+
+static void initWindows(board_t *board);
+static void findWindows(uint8_t   size,
+                        uint8_t   length,
+                        uint16_t *windows,
+                        uint8_t  *windowCounts);
+static void addSymbol(board_t *board,
+                      uint8_t  cell,
+                      char     symbol);
+static void removeSymbol(board_t *board,
+                         uint8_t  cell);
+static void updateWindows(board_t *board,
+                          uint8_t  cell,
+                          uint8_t  symbol,
+                          bool     isAdded);
+
+static void initTables();
+
+static void updateHashes(board_t *board,
+                         uint8_t  cell,
+                         uint8_t  symbol);
+static uint64_t mixKey(uint64_t key);
+
+static uint8_t getSymbolIndex(char symbol);
+static uint16_t getCellBit(board_t *board,
+                           uint8_t  cell);
 
 
 /* ------------------------------ START PUBLIC ------------------------------ */
@@ -30,6 +126,7 @@ static bool isWinBackwardDiag(board_t *board,
 /*
 @context
     * Initialises an empty board.
+    * To win a symbol must fill an entire row, column or diagonal.
 
 @parameters
     * size
@@ -40,27 +137,134 @@ static bool isWinBackwardDiag(board_t *board,
     * Empty board.
 */
 board_t *initBoard(uint8_t size)
+{
+    return initBoardLength(size, size);
+}
+
+
+/*
+@context
+    * Initialises an empty board where `length` in a row wins.
+    * To win a symbol must fill `length` consecutive cells of a row, column or
+      diagonal (a window).
+
+@parameters
+    * size
+        * Width and height of the board.
+        * The board is always square.
+    * length
+        * Number of consecutive cells to win.
+        * Cannot be larger than `size`.
+
+@return
+    * Empty board.
+*/
+board_t *initBoardLength(uint8_t size,
+                         uint8_t length)
+{
+    boardstorage_t *storage;
+
+    storage = malloc(sizeof(boardstorage_t));
+    assert(storage != NULL);
+
+    return initBoardStorage(storage, size, length);
+}
+
+
+/*
+@context
+    * Initialises an empty board within `storage` instead of allocating it
+      (same as `initBoardLength` otherwise).
+    * `storage` can be on the stack, within another structure or an arena so
+      no memory is allocated (after the first board of each size and length).
+    * The board is only valid while `storage` is and must not be freed with
+      `freeBoard` - initialising `storage` again replaces it.
+
+@parameters
+    * storage
+        * Memory to initialise the board within.
+    * size
+        * Width and height of the board.
+    * length
+        * Number of consecutive cells to win.
+        * Cannot be larger than `size`.
+
+@return
+    * Empty board within `storage`.
+*/
+board_t *initBoardStorage(boardstorage_t *storage,
+                          uint8_t         size,
+                          uint8_t         length)
 {
     board_t *board;
 
-    board = malloc(sizeof(board_t));
-    assert(board != NULL);
+    assert(size > 0 && size <= BOARD_MAX_SIZE);
+    assert(length > 0 && length <= size);
 
-    board->size = size;
+    call_once(&tablesFlag, initTables);
 
-    // instead of a 2D array a 1D array is used cells organised row-wise
-    board->cells = malloc(sizeof(char) * size);
-    assert(board->cells != NULL);
+    board = (board_t *)storage;
+    board->size = size;
+    board->length = length;
 
+    initWindows(board);
     resetBoard(board);
 
     return board;
 }
 
 
+/*
+@context
+    * Initialises a copy of `board`.
+    * The copy is independent so can be changed (or used by another thread)
+      without changing `board`.
+
+@parameters
+    * board
+        * Board to copy.
+
+@return
+    * Copy of `board`.
+*/
+board_t *cloneBoard(board_t *board)
+{
+    boardstorage_t *storage;
+
+    storage = malloc(sizeof(boardstorage_t));
+    assert(storage != NULL);
+
+    return copyBoard(board, storage);
+}
+
+
+/*
+@context
+    * Copies `board` into `storage` (same as `cloneBoard` without allocating).
+    * Any board previously within `storage` is replaced.
+
+@parameters
+    * board
+        * Board to copy.
+    * storage
+        * Memory to copy `board` into.
+
+@return
+    * Copy of `board` within `storage`.
+*/
+board_t *copyBoard(board_t        *board,
+                   boardstorage_t *storage)
+{
+    memcpy(storage, board, sizeof(board_t));
+    return (board_t *)storage;
+}
+
+
 /*
 @context
     * Frees `board`.
+    * Only boards from `initBoard`, `initBoardLength` and `cloneBoard` are
+      freed - not boards within caller storage.
 
 @parameters
     * board
@@ -68,7 +272,6 @@ board_t *initBoard(uint8_t size)
 */
 void freeBoard(board_t *board)
 {
-    free(board->cells);
     free(board);
 }
 
@@ -83,11 +286,37 @@ void freeBoard(board_t *board)
 */
 void resetBoard(board_t *board)
 {
-    uint8_t cell;
+    uint16_t window, windows;
+    uint8_t cell, symbol, symmetry;
 
+    // every window of 1 cell is 1 cell from filled while the board is empty
+    windows = 0;
     for (cell = 0; cell < board->size * board->size; cell += 1)
     {
         board->cells[cell] = EMPTY;
+        windows += board->length == 1 ? board->windowCounts[cell] : 0;
+    }
+
+    for (symbol = 0; symbol < 2; symbol += 1)
+    {
+        clearBitboard(&board->symbols[symbol]);
+
+        for (window = 0; window < BOARD_MAX_WINDOWS; window += 1)
+        {
+            board->counts[symbol][window] = 0;
+        }
+        board->wins[symbol] = 0;
+        board->winsNext[symbol] = windows;
+        board->threats[symbol] = 0;
+    }
+
+    // keys are the same for every size so the size and length are also hashed
+    board->filled = 0;
+    board->moveCount = 0;
+    for (symmetry = 0; symmetry < SYMMETRY_COUNT; symmetry += 1)
+    {
+        board->hashes[symmetry] =
+            mixKey((BOARD_MAX_SIZE * (board->length - 1)) + board->size - 1);
     }
 }
 
@@ -95,7 +324,8 @@ void resetBoard(board_t *board)
 /*
 @context
     * Determines if a game ends in a win for `symbol`.
-    * Wins if `symbol` fills at least 1 row, column or diagonal.
+    * Wins if `symbol` fills at least 1 window (`length` cells in a row).
+    * Constant time as filled windows are counted as each move is made.
 
 @parameters
     * board
@@ -109,24 +339,29 @@ void resetBoard(board_t *board)
 bool isWin(board_t *board,
            char     symbol)
 {
-    uint8_t i;
+    return board->wins[getSymbolIndex(symbol)] > 0;
+}
 
-    // check both diagonals for a win
-    if (isWinForwardDiag(board, symbol) || isWinBackwardDiag(board, symbol))
-    {
-        return true;
-    }
 
-    // check each row and column
-    for (i = 0; i < board->size; i += 1)
-    {
-        if (isWinRow(board, i, symbol) || isWinCol(board, i, symbol))
-        {
-            return true;
-        }
-    }
+/*
+@context
+    * Determines if `symbol` can win with its next move.
+    * Constant time as windows 1 cell from filled are counted as each move is
+      made.
 
-    return false;
+@parameters
+    * board
+        * Board to check.
+    * symbol
+        * Symbol to move next.
+
+@return
+    * Indicates if a window only held by `symbol` has 1 empty cell left.
+*/
+bool isWinNext(board_t *board,
+               char     symbol)
+{
+    return board->winsNext[getSymbolIndex(symbol)] > 0;
 }
 
 
@@ -144,24 +379,26 @@ bool isWin(board_t *board,
 */
 bool isDraw(board_t *board)
 {
-    uint8_t cell;
-
     // no draw if there is a win - even if `board` full
-    if (isWin(board, NOUGHT) || isWin(board, CROSS))
-    {
-        return false;
-    }
+    return board->wins[0] == 0 && board->wins[1] == 0 && isFull(board);
+}
 
-    // check if any cells are empty
-    for (cell = 0; cell < board->size * board->size; cell += 1)
-    {
-        if (board->cells[cell] == EMPTY)
-        {
-            return false;
-        }
-    }
 
-    return true;
+/*
+@context
+    * Determines if every cell within `board` has a symbol.
+    * Unlike `isDraw` a full `board` may also contain a win.
+
+@parameters
+    * board
+        * Board to determine if full.
+
+@return
+    * Indicates if `board` is full.
+*/
+bool isFull(board_t *board)
+{
+    return board->filled == board->size * board->size;
 }
 
 
@@ -191,6 +428,116 @@ bool isValidMove(board_t *board,
 }
 
 
+/*
+@context
+    * Gets every cell which wins for `symbol` if placed - every empty cell of
+      a window only held by `symbol` which is 1 cell from filled.
+    * Only searches the cells when `isWinNext` is true - found with
+      bitboards (`getCompletions`) so every window is searched at once.
+
+@parameters
+    * board
+        * Board to get the winning cells of.
+    * symbol
+        * Symbol to place.
+    * cells
+        * Filled with every winning cell in cell order.
+        * Requires space for every cell of `board`.
+
+@return
+    * Number of winning cells.
+*/
+uint8_t getWinningMoves(board_t *board,
+                        char     symbol,
+                        uint8_t  cells[])
+{
+    bitboard_t empty, winning;
+    uint8_t row, column, count, index, i;
+
+    index = getSymbolIndex(symbol);
+    if (board->winsNext[index] == 0)
+    {
+        return 0;
+    }
+
+    for (i = 0; i < BITBOARD_WORDS; i += 1)
+    {
+        empty.words[i] = cellMasks[board->size].words[i]
+            & ~(board->symbols[0].words[i] | board->symbols[1].words[i]);
+    }
+    getCompletions(&board->symbols[index], &empty, board->length, &winning);
+
+    count = 0;
+    for (row = 0; row < board->size; row += 1)
+    {
+        for (column = 0; column < board->size; column += 1)
+        {
+            if (isBitSet(&winning, getBit(row, column)))
+            {
+                cells[count] = (row * board->size) + column;
+                count += 1;
+            }
+        }
+    }
+
+    return count;
+}
+
+
+/*
+@context
+    * Gets every empty cell within `distance` rows and columns of a cell
+      which is not empty.
+    * Found with bitboards so takes the same time however many cells are
+      filled.
+
+@parameters
+    * board
+        * Board to get the cells of.
+    * distance
+        * Most rows (and columns) from a cell which is not empty.
+    * cells
+        * Filled with every cell found in cell order.
+        * Requires space for every cell of `board`.
+
+@return
+    * Number of cells found (`0` if `board` is empty).
+*/
+uint8_t getNearMoves(board_t *board,
+                     uint8_t  distance,
+                     uint8_t  cells[])
+{
+    bitboard_t near;
+    uint8_t row, column, count, i;
+
+    for (i = 0; i < BITBOARD_WORDS; i += 1)
+    {
+        near.words[i] = board->symbols[0].words[i]
+            | board->symbols[1].words[i];
+    }
+    for (i = 0; i < distance; i += 1)
+    {
+        dilateBitboard(&near, &cellMasks[board->size]);
+    }
+
+    count = 0;
+    for (row = 0; row < board->size; row += 1)
+    {
+        for (column = 0; column < board->size; column += 1)
+        {
+            if (isBitSet(&near, getBit(row, column))
+                && board->cells[(row * board->size) + column] == EMPTY)
+            {
+                cells[count] = (row * board->size) + column;
+                count += 1;
+            }
+        }
+    }
+
+    return count;
+}
+
+
 /*
 @context
     * Gets the size of `board`.
@@ -209,6 +556,181 @@ uint8_t getSize(board_t *board)
 }
 
 
+/*
+@context
+    * Gets the number of consecutive cells a symbol must fill to win.
+
+@parameters
+    * board
+        * Board to get the length of.
+
+@return
+    * Win length of `board`.
+*/
+uint8_t getLength(board_t *board)
+{
+    return board->length;
+}
+
+
+/*
+@context
+    * Gets the number of windows `cell` is part of.
+    * Cells within more windows can be part of more wins.
+
+@parameters
+    * board
+        * Board `cell` is within.
+    * cell
+        * Position in `board` to count the windows of.
+
+@return
+    * Number of windows `cell` is part of.
+*/
+uint8_t getWindowCount(board_t *board,
+                       uint8_t  cell)
+{
+    assert(isValidMove(board, cell, EMPTY));
+    return board->windowCounts[cell];
+}
+
+
+/*
+@context
+    * Gets the number of empty cells within `board`.
+    * This is the most moves that can still be made.
+
+@parameters
+    * board
+        * Board to count the empty cells of.
+
+@return
+    * Number of empty cells within `board`.
+*/
+uint8_t getEmptyCount(board_t *board)
+{
+    return (board->size * board->size) - board->filled;
+}
+
+
+/*
+@context
+    * Gets a heuristic evaluation of how close `symbol` is to winning compared
+      to its opponent.
+    * Every window only held by a single symbol is a threat - weighted by how
+      many of its cells are held (each cell weighted 4 times the last).
+    * Constant time as threats are updated as each move is made.
+    * Used to score states when a search is stopped before the game ends.
+
+@parameters
+    * board
+        * Board to evaluate.
+    * symbol
+        * Symbol to evaluate for.
+
+@return
+    * Threats of `symbol` less the threats of its opponent.
+    * Positive when `symbol` is closer to winning.
+*/
+int32_t getEvaluation(board_t *board,
+                      char     symbol)
+{
+    uint8_t index;
+
+    index = getSymbolIndex(symbol);
+    return board->threats[index] - board->threats[1 - index];
+}
+
+
+/*
+@context
+    * Gets the Zobrist hash of the cells within `board`.
+    * Equal boards always have equal hashes (different boards almost never).
+
+@parameters
+    * board
+        * Board to get the hash of.
+
+@return
+    * Hash of `board`.
+*/
+uint64_t getHash(board_t *board)
+{
+    return board->hashes[SYMMETRY_IDENTITY];
+}
+
+
+/*
+@context
+    * Gets the hash shared by `board` and every symmetry of `board`.
+    * The hash is of the symmetry of `board` with the smallest hash.
+
+@parameters
+    * board
+        * Board to get the hash of.
+    * symmetry
+        * Set to the symmetry which transforms `board` into the hashed board.
+        * Cells of `board` must be transformed by it to match the hash.
+
+@return
+    * Hash of every symmetry of `board`.
+*/
+uint64_t getCanonicalHash(board_t *board,
+                          uint8_t *symmetry)
+{
+    uint8_t i;
+
+    *symmetry = SYMMETRY_IDENTITY;
+    for (i = 1; i < SYMMETRY_COUNT; i += 1)
+    {
+        if (board->hashes[i] < board->hashes[*symmetry])
+        {
+            *symmetry = i;
+        }
+    }
+
+    return board->hashes[*symmetry];
+}
+
+
+/*
+@context
+    * Determines if `board` is unchanged by `symmetry`.
+    * Moves in cells mapped onto each other by `symmetry` are then equivalent.
+
+@parameters
+    * board
+        * Board to check.
+    * symmetry
+        * Symmetry to transform `board` by.
+
+@return
+    * Indicates if `board` is unchanged by `symmetry`.
+*/
+bool isSymmetric(board_t *board,
+                 uint8_t  symmetry)
+{
+    uint8_t cell;
+
+    // different hashes are always different boards (equal almost always same)
+    if (board->hashes[symmetry] != board->hashes[SYMMETRY_IDENTITY])
+    {
+        return false;
+    }
+
+    for (cell = 0; cell < board->size * board->size; cell += 1)
+    {
+        if (board->cells[cell]
+            != board->cells[transformCell(board->size, cell, symmetry)])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
 /*
 @context
     * Gets the symbol at `cell` within `board`.
@@ -230,10 +752,36 @@ char getCell(board_t *board,
 }
 
 
+/*
+@context
+    * Gets every cell of `symbol` within `board` as a bitboard (see
+      `getBit`).
+
+@parameters
+    * board
+        * Board to get the cells of.
+    * symbol
+        * Symbol to get the cells of.
+    * bitboard
+        * Set to the cells of `symbol`.
+*/
+void getSymbolBitboard(board_t    *board,
+                       char        symbol,
+                       bitboard_t *bitboard)
+{
+    *bitboard = board->symbols[getSymbolIndex(symbol)];
+}
+
+
 /*
 @context
     * Sets the `cell` within `board` to `symbol`.
     * Used to make (`NOUGHT` or `CROSS`) or unmake (`EMPTY`) moves.
+    * Window counts are updated so wins and draws can be found in constant
+      time.
+    * Hashes are updated by toggling the key of the changed symbol.
+    * Not part of the move history - cells of moves made by `makeMove` are
+      only emptied by `unmakeMove`.
 
 @parameters
     * board
@@ -251,7 +799,102 @@ void setCell(board_t *board,
 {
     assert(symbol == NOUGHT || symbol == CROSS || symbol == EMPTY);
     assert(isValidMove(board, cell, symbol));
-    board->cells[cell] = symbol;
+
+    // unmaking a move removes the cell from whichever symbol held it
+    if (symbol == EMPTY)
+    {
+        if (board->cells[cell] != EMPTY)
+        {
+            removeSymbol(board, cell);
+        }
+    }
+    else
+    {
+        addSymbol(board, cell, symbol);
+    }
+}
+
+
+/*
+@context
+    * Makes the move of `symbol` in `cell` and adds it to the move history of
+      `board` - undone by `unmakeMove`.
+    * Same as `setCell` without validating the move (`cell` is only asserted
+      empty) so costs no more than updating the window counts and hashes -
+      used at every state of a search.
+
+@parameters
+    * board
+        * Board to make the move in.
+    * cell
+        * Empty position in `board` to move in.
+    * symbol
+        * Symbol to move (`NOUGHT` or `CROSS`).
+*/
+void makeMove(board_t *board,
+              uint8_t  cell,
+              char     symbol)
+{
+    assert(board->cells[cell] == EMPTY);
+
+    addSymbol(board, cell, symbol);
+
+    board->moves[board->moveCount] = cell;
+    board->moveCount += 1;
+}
+
+
+/*
+@context
+    * Unmakes the last move made by `makeMove` - restoring its cell, window
+      counts and hashes - and removes it from the move history.
+
+@parameters
+    * board
+        * Board to unmake the move in (at least 1 move made).
+*/
+void unmakeMove(board_t *board)
+{
+    assert(board->moveCount > 0);
+
+    board->moveCount -= 1;
+    removeSymbol(board, board->moves[board->moveCount]);
+}
+
+
+/*
+@context
+    * Gets the number of moves made by `makeMove` not yet unmade.
+
+@parameters
+    * board
+        * Board to get the move history of.
+
+@return
+    * Number of moves within the move history.
+*/
+uint8_t getMoveCount(board_t *board)
+{
+    return board->moveCount;
+}
+
+
+/*
+@context
+    * Gets the cell of the last move made by `makeMove` not yet unmade.
+
+@parameters
+    * board
+        * Board to get the move history of (at least 1 move made).
+
+@return
+    * Cell of the last move.
+*/
+uint8_t getLastMove(board_t *board)
+{
+    assert(board->moveCount > 0);
+
+    return board->moves[board->moveCount - 1];
 }
 
 
@@ -261,125 +904,367 @@ void setCell(board_t *board,
 
 /*
 @context
-    * Determines if a single `row` ends a game in a win for `symbol`.
+    * Places `symbol` in the empty `cell` updating every count and hash.
 
 @parameters
     * board
-        * Board to determine if ended in a win for `symbol`.
-    * row
-        * Row to check if won in.
-        * Range: `0` to `board->size - 1`
+        * Board to place `symbol` within.
+    * cell
+        * Empty position in `board`.
     * symbol
-        * Symbol to determine if they have won.
+        * Symbol to place (`NOUGHT` or `CROSS`).
+*/
+static void addSymbol(board_t *board,
+                      uint8_t  cell,
+                      char     symbol)
+{
+    uint8_t index;
 
-@return
-    * Indicates if the game ends in a win for `symbol` in `row`.
+    index = getSymbolIndex(symbol);
+    setBit(&board->symbols[index], getCellBit(board, cell));
+    updateWindows(board, cell, index, true);
+    board->filled += 1;
+    updateHashes(board, cell, index);
+
+    board->cells[cell] = symbol;
+}
+
+
+/*
+@context
+    * Empties the filled `cell` updating every count and hash.
+
+@parameters
+    * board
+        * Board to empty `cell` within.
+    * cell
+        * Position in `board` which is not empty.
 */
-static bool isWinRow(board_t *board,
-                     uint8_t  row,
-                     char     symbol)
+static void removeSymbol(board_t *board,
+                         uint8_t  cell)
 {
-    uint8_t i;
+    uint8_t index;
 
-    for (i = 0; i < board->size; i += 1)
+    index = getSymbolIndex(board->cells[cell]);
+    unsetBit(&board->symbols[index], getCellBit(board, cell));
+    updateWindows(board, cell, index, false);
+    board->filled -= 1;
+    updateHashes(board, cell, index);
+
+    board->cells[cell] = EMPTY;
+}
+
+
+/*
+@context
+    * Sets the windows of `board` to those of its size and length.
+    * Windows are only found by the first board of each size and length then
+      shared by every later board.
+
+@parameters
+    * board
+        * Board to set the windows of.
+*/
+static void initWindows(board_t *board)
+{
+    uint16_t *windows;
+    uint8_t *windowCounts;
+    uint8_t size, length;
+
+    size = board->size;
+    length = board->length;
+
+    mtx_lock(&windowsLock);
+    if (windowTables[size][length] == NULL)
     {
-        if (board->cells[(board->size * row) + i] != symbol)
+        windows = malloc(sizeof(uint16_t) * size * size
+            * BOARD_DIRECTIONS * length);
+        windowCounts = malloc(sizeof(uint8_t) * size * size);
+        assert(windows != NULL && windowCounts != NULL);
+
+        findWindows(size, length, windows, windowCounts);
+        windowTables[size][length] = windows;
+        windowCountTables[size][length] = windowCounts;
+    }
+    board->windows = windowTables[size][length];
+    board->windowCounts = windowCountTables[size][length];
+    mtx_unlock(&windowsLock);
+}
+
+
+/*
+@context
+    * Finds every window of a board and the windows each cell is part of.
+    * A window is `length` consecutive cells along a row, column or diagonal.
+    * Windows are indexed by their direction and then their first cell.
+
+@parameters
+    * size
+        * Width and height of the board.
+    * length
+        * Number of consecutive cells to win.
+    * windows
+        * Filled with the windows of each cell (`BOARD_DIRECTIONS * length`
+          per cell).
+    * windowCounts
+        * Filled with the number of windows of each cell.
+*/
+static void findWindows(uint8_t   size,
+                        uint8_t   length,
+                        uint16_t *windows,
+                        uint8_t  *windowCounts)
+{
+    uint8_t direction, cell, row, column, step, windowCell, i;
+    int lastRow, lastColumn;
+    uint16_t window;
+
+    for (cell = 0; cell < size * size; cell += 1)
+    {
+        windowCounts[cell] = 0;
+    }
+
+    for (direction = 0; direction < BOARD_DIRECTIONS; direction += 1)
+    {
+        for (cell = 0; cell < size * size; cell += 1)
         {
-            return false;
+            row = cell / size;
+            column = cell % size;
+
+            // only windows which fit within the board are used
+            lastRow = row + (DIRECTION_ROWS[direction] * (length - 1));
+            lastColumn = column + (DIRECTION_COLUMNS[direction] * (length - 1));
+            if (lastRow >= size || lastColumn < 0 || lastColumn >= size)
+            {
+                continue;
+            }
+
+            // add the window to each of its cells
+            window = (direction * BOARD_MAX_CELLS) + cell;
+            step = (DIRECTION_ROWS[direction] * size)
+                + DIRECTION_COLUMNS[direction];
+            for (i = 0; i < length; i += 1)
+            {
+                windowCell = cell + (i * step);
+                windows[(windowCell * BOARD_DIRECTIONS * length)
+                    + windowCounts[windowCell]] = window;
+                windowCounts[windowCell] += 1;
+            }
         }
     }
-    return true;
 }
 
 
 /*
 @context
-    * Determines if a single `column` ends a game in a win for `symbol`.
+    * Updates the count of `symbol` in every window `cell` is part of.
+    * Tracks how many windows `symbol` has filled so wins are constant time,
+      and how many it is 1 cell from filling.
+    * Tracks the threats of both symbols - a window is a threat of a symbol
+      while only that symbol holds cells within it.
 
 @parameters
     * board
-        * Board to determine if ended in a win for `symbol`.
-    * column
-        * Column to check if won in.
-        * Range: `0` to `board->size - 1`
+        * Board `cell` is within.
+    * cell
+        * Position in `board` that changed.
     * symbol
-        * Symbol to determine if they have won.
+        * Index of the symbol added or removed from `cell`.
+    * isAdded
+        * Indicates if `symbol` was added to (otherwise removed from) `cell`.
+*/
+static void updateWindows(board_t *board,
+                          uint8_t  cell,
+                          uint8_t  symbol,
+                          bool     isAdded)
+{
+    const uint16_t *windows;
+    uint8_t i, opponent, held, opponentHeld;
+    int32_t sign;
 
-@return
-    * Indicates if the game ends in a win for `symbol` in `column`.
+    windows = &board->windows[cell * BOARD_DIRECTIONS * board->length];
+    sign = isAdded ? 1 : -1;
+    opponent = 1 - symbol;
+
+    for (i = 0; i < board->windowCounts[cell]; i += 1)
+    {
+        // counts without `symbol` in `cell` so adding and removing are mirrored
+        if (!isAdded)
+        {
+            board->counts[symbol][windows[i]] -= 1;
+        }
+        held = board->counts[symbol][windows[i]];
+        opponentHeld = board->counts[opponent][windows[i]];
+
+        if (opponentHeld == 0)
+        {
+            // window remains a threat of `symbol` - now with 1 more (or less)
+            board->threats[symbol] += sign
+                * (threatWeights[held + 1] - threatWeights[held]);
+            if (held + 1 == board->length)
+            {
+                board->wins[symbol] += isAdded ? 1 : -1;
+                board->winsNext[symbol] -= isAdded ? 1 : -1;
+            }
+            else if (held + 2 == board->length)
+            {
+                board->winsNext[symbol] += isAdded ? 1 : -1;
+            }
+        }
+        else if (held == 0)
+        {
+            // window stops (or starts again) being a threat of the opponent
+            board->threats[opponent] -= sign * threatWeights[opponentHeld];
+            if (opponentHeld + 1 == board->length)
+            {
+                board->winsNext[opponent] -= isAdded ? 1 : -1;
+            }
+        }
+
+        if (isAdded)
+        {
+            board->counts[symbol][windows[i]] += 1;
+        }
+    }
+}
+
+
+/*
+@context
+    * Fills the tables shared by every board.
+    * Only called once - before the first board is initialised.
 */
-static bool isWinCol(board_t *board,
-                     uint8_t  column,
-                     char     symbol)
+static void initTables()
 {
-    uint8_t i;
+    uint8_t cells[SYMMETRY_COUNT];
+    uint8_t size, cell, symmetry, count, shift;
+    uint16_t bit;
+
+    initLines();
 
-    for (i = 0; i < board->size; i += 1)
+    for (size = 1; size <= BOARD_MAX_SIZE; size += 1)
     {
-        if (board->cells[column + (board->size * i)] != symbol)
+        for (cell = 0; cell < size * size; cell += 1)
         {
-            return false;
+            getSymmetricCells(size, cell, cells);
+            for (symmetry = 0; symmetry < SYMMETRY_COUNT; symmetry += 1)
+            {
+                symmetricBits[size][cell][symmetry] =
+                    getBit(cells[symmetry] / size, cells[symmetry] % size);
+            }
+            setBit(&cellMasks[size], getBit(cell / size, cell % size));
         }
     }
-    return true;
+
+    // keys of the first symbol are at even values and the second at odd values
+    // (after the values used to hash each size and length of a board)
+    for (bit = 0; bit < BITBOARD_BITS; bit += 1)
+    {
+        zobristKeys[bit][0] =
+            mixKey((uint64_t)BOARD_MAX_SIZE * BOARD_MAX_SIZE + (2 * bit));
+        zobristKeys[bit][1] =
+            mixKey((uint64_t)BOARD_MAX_SIZE * BOARD_MAX_SIZE + (2 * bit) + 1);
+    }
+
+    mtx_init(&windowsLock, mtx_plain);
+
+    // an empty window is not a threat - each held cell is 4 times the last
+    threatWeights[0] = 0;
+    for (count = 1; count <= BOARD_MAX_SIZE; count += 1)
+    {
+        shift = 2 * (count - 1);
+        threatWeights[count] = 1 << (shift < THREAT_MAX_SHIFT
+                                     ? shift
+                                     : THREAT_MAX_SHIFT);
+    }
 }
 
 
 /*
 @context
-    * Determines if the forward (\) diagonal ends a game in a win for `symbol`.
+    * Toggles `symbol` in `cell` within the hash of every symmetry of `board`.
 
 @parameters
     * board
-        * Board to determine if ended in a win for `symbol`.
+        * Board `cell` is within.
+    * cell
+        * Position in `board` that changed.
     * symbol
-        * Symbol to determine if they have won.
-
-@return
-    * Indicates if the game ends in a win for `symbol` in the forward diagonal.
+        * Index of the symbol added or removed from `cell`.
 */
-static bool isWinForwardDiag(board_t *board,
-                             char     symbol)
+static void updateHashes(board_t *board,
+                         uint8_t  cell,
+                         uint8_t  symbol)
 {
-    uint8_t i;
+    const uint8_t *bits;
+    uint8_t symmetry;
 
-    for (i = 0; i < board->size; i += 1)
+    bits = symmetricBits[board->size][cell];
+    for (symmetry = 0; symmetry < SYMMETRY_COUNT; symmetry += 1)
     {
-        if (board->cells[(board->size * i) + i] != symbol)
-        {
-            return false;
-        }
+        board->hashes[symmetry] ^= zobristKeys[bits[symmetry]][symbol];
     }
-    return true;
 }
 
 
 /*
 @context
-    * Determines if the backward (/) diagonal ends a game in a win for `symbol`.
+    * Mixes `key` into a pseudo-random Zobrist key.
+    * Uses the SplitMix64 mixing function instead of a random number generator
+      so keys are identical between runs.
+
+@parameters
+    * key
+        * Value to mix - each different value gives a different key.
+
+@return
+    * Pseudo-random key of `key`.
+*/
+static uint64_t mixKey(uint64_t key)
+{
+    key = (key + 1) * 0x9E3779B97F4A7C15;
+    key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9;
+    key = (key ^ (key >> 27)) * 0x94D049BB133111EB;
+    return key ^ (key >> 31);
+}
+
+
+/*
+@context
+    * Gets the index of `symbol` used to access per symbol state.
 
 @parameters
-    * board
-        * Board to determine if ended in a win for `symbol`.
     * symbol
-        * Symbol to determine if they have won.
+        * Symbol to get the index of.
+        * Only `NOUGHT` or `CROSS` allowed.
 
 @return
-    * Indicates if the game ends in a win for `symbol` in the backward diagonal.
+    * `0` for `NOUGHT` and `1` for `CROSS`.
 */
-static bool isWinBackwardDiag(board_t *board,
-                              char     symbol)
+static uint8_t getSymbolIndex(char symbol)
 {
-    uint8_t i;
+    assert(symbol == NOUGHT || symbol == CROSS);
+    return symbol == NOUGHT ? 0 : 1;
+}
 
-    for (i = 0; i < board->size; i += 1)
-    {
-        if (board->cells[(board->size * (board->size - 1 - i)) + i] != symbol)
-        {
-            return false;
-        }
-    }
-    return true;
+
+/*
+@context
+    * Gets the bitboard bit of `cell`.
+    * Rows of the bitboard are wider than `board` so cells are remapped.
+
+@parameters
+    * board
+        * Board `cell` is within.
+    * cell
+        * Position in `board` to get the bit of.
+
+@return
+    * Bit of `cell` within a bitboard.
+*/
+static uint16_t getCellBit(board_t *board,
+                           uint8_t  cell)
+{
+    return symmetricBits[board->size][cell][SYMMETRY_IDENTITY];
 }
 
 
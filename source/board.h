@@ -4,6 +4,21 @@
     * Although Noughts and Crosses is usually a 3x3 game it can be set to any
       size with this data structure.
     * To win user must fill a row, column or diagonal with their symbol.
+        * Boards can instead be won by filling a smaller number of consecutive
+          cells (k in a row) of a row, column or diagonal.
+    * Each symbol's cells are also kept as a bitboard.
+    * The cells of each symbol in every window (cells which win if filled) are
+      counted as moves are made and unmade so wins and draws are found in
+      constant time.
+    * Windows only held by 1 symbol are threats - weighted to evaluate states
+      searches cannot reach the end of.
+    * A Zobrist hash of the cells (and of each symmetry of the cells) is also
+      updated as moves are made and unmade.
+    * Moves made by `makeMove` are kept on a move stack so `unmakeMove` undoes
+      the last without being given its cell or validating it again.
+    * A board is a single fixed size block so it can be initialised within
+      caller memory (`initBoardStorage`) and copied with 1 `memcpy`
+      (`copyBoard`) - the windows of each size and length are shared.
 */
 
 
@@ -13,6 +28,12 @@
     #include <stdbool.h>
     #include <stdint.h>
 
+    #include "bitboard.h"
+
+
+    // largest board a bitboard can store (cells must also fit in `uint8_t`)
+    #define BOARD_MAX_SIZE 15
+
 
     static const char NOUGHT = 'O';
     static const char CROSS = 'X';
@@ -23,26 +44,73 @@
 
     typedef struct board_s board_t;
 
+    // words of memory a board needs - boards can be initialised within any
+    // `boardstorage_t` (on the stack or within an arena) instead of allocated
+    #define BOARD_STORAGE_WORDS 320
+
+    typedef struct
+    {
+        uint64_t words[BOARD_STORAGE_WORDS];
+    } boardstorage_t;
+
 
     board_t *initBoard(uint8_t size);
+    board_t *initBoardLength(uint8_t size,
+                             uint8_t length);
+    board_t *initBoardStorage(boardstorage_t *storage,
+                              uint8_t         size,
+                              uint8_t         length);
+    board_t *cloneBoard(board_t *board);
+    board_t *copyBoard(board_t        *board,
+                       boardstorage_t *storage);
     void freeBoard(board_t *board);
 
     void resetBoard(board_t *board);
 
     bool isWin(board_t *board,
                char     symbol);
+    bool isWinNext(board_t *board,
+                   char     symbol);
     bool isDraw(board_t *board);
+    bool isFull(board_t *board);
 
     bool isValidMove(board_t *board,
                      uint8_t  cell,
                      char     symbol);
+    uint8_t getWinningMoves(board_t *board,
+                            char     symbol,
+                            uint8_t  cells[]);
+    uint8_t getNearMoves(board_t *board,
+                         uint8_t  distance,
+                         uint8_t  cells[]);
 
     uint8_t getSize(board_t *board);
+    uint8_t getLength(board_t *board);
+    uint8_t getWindowCount(board_t *board,
+                           uint8_t  cell);
+    uint8_t getEmptyCount(board_t *board);
+    int32_t getEvaluation(board_t *board,
+                          char     symbol);
+    uint64_t getHash(board_t *board);
+    uint64_t getCanonicalHash(board_t *board,
+                              uint8_t *symmetry);
+
+    bool isSymmetric(board_t *board,
+                     uint8_t  symmetry);
     char getCell(board_t *board,
                  uint8_t  cell);
+    void getSymbolBitboard(board_t    *board,
+                           char        symbol,
+                           bitboard_t *bitboard);
 
     void setCell(board_t *board,
                  uint8_t  cell,
                  char     symbol);
+    void makeMove(board_t *board,
+                  uint8_t  cell,
+                  char     symbol);
+    void unmakeMove(board_t *board);
+    uint8_t getMoveCount(board_t *board);
+    uint8_t getLastMove(board_t *board);
 
 #endif
@@ -0,0 +1,117 @@
+#include "book.h"
+
+
+#ifdef BOOK_TABLE
+    // generated by `bookgen` - entry of every state indexed by `getBookIndex`
+    static const bookentry_t BOOK[BOOK_ENTRIES] = {
+        #include "book.inc"
+    };
+#endif
+
+
+/* ------------------------------ START PUBLIC ------------------------------ */
+
+
+/*
+@context
+    * Looks up the optimal move of `symbolSelf` in current `board` state.
+    * Only found if `board` is 3x3 (3 in a row), not ended and `symbolSelf`
+      moves next.
+
+@parameters
+    * board
+        * Current state of the Noughts and Crosses game.
+    * symbolSelf
+        * Symbol to find best move for.
+    * move
+        * Set to the cell of the optimal move if found.
+    * score
+        * Set to the score of the optimal move if found.
+
+@return
+    * Indicates if the optimal move was found.
+*/
+bool lookupBook(board_t *board,
+                char     symbolSelf,
+                uint8_t *move,
+                score_t *score)
+{
+#ifdef BOOK_TABLE
+    const bookentry_t *entry;
+    uint8_t cell;
+    int8_t balance;
+
+    if (getSize(board) != BOOK_SIZE || getLength(board) != BOOK_SIZE)
+    {
+        return false;
+    }
+
+    // book only holds states where `symbolSelf` is the symbol to move
+    balance = 0;
+    for (cell = 0; cell < BOOK_SIZE * BOOK_SIZE; cell += 1)
+    {
+        balance += getCell(board, cell) == NOUGHT;
+        balance -= getCell(board, cell) == CROSS;
+    }
+    if (symbolSelf != (balance == 0 ? NOUGHT : CROSS))
+    {
+        return false;
+    }
+
+    entry = &BOOK[getBookIndex(board)];
+    if (entry->move == BOOK_MOVE_NONE)
+    {
+        return false;
+    }
+
+    *move = entry->move;
+    *score = SCORE_DRAW;
+    if (entry->distance > 0)
+    {
+        *score = SCORE_WIN - entry->distance;
+    }
+    else if (entry->distance < 0)
+    {
+        *score = SCORE_LOSE - entry->distance;
+    }
+    return true;
+#else
+    (void)board;
+    (void)symbolSelf;
+    (void)move;
+    (void)score;
+    return false;
+#endif
+}
+
+
+/*
+@context
+    * Gets the index of `board` within the book.
+    * Each cell is a base 3 digit (`0` empty, `1` nought and `2` cross).
+
+@parameters
+    * board
+        * 3x3 board to get the index of.
+
+@return
+    * Index of `board` within the book.
+*/
+uint16_t getBookIndex(board_t *board)
+{
+    uint16_t index;
+    int8_t cell;
+    char symbol;
+
+    index = 0;
+    for (cell = (BOOK_SIZE * BOOK_SIZE) - 1; cell >= 0; cell -= 1)
+    {
+        symbol = getCell(board, cell);
+        index = (index * 3) + (symbol == NOUGHT ? 1 : symbol == CROSS ? 2 : 0);
+    }
+
+    return index;
+}
+
+
+/* ------------------------------- END PUBLIC ------------------------------- */
@@ -0,0 +1,53 @@
+/*
+@context
+    * Provides the optimal move and score of every reachable 3x3 state.
+        * Built by solving every state at once with `bookgen` (included into
+          `book.c` from the generated `book.inc` when compiled with
+          `BOOK_TABLE` defined).
+        * Without `BOOK_TABLE` defined the book is empty and every lookup
+          fails, which is how engines without the book are built (such as
+          `benchmark`).
+    * States are indexed in base 3 where each cell is a digit (`0` empty,
+      `1` nought and `2` cross) and the first cell is the lowest digit.
+    * The symbol to move is assumed to be the one with less symbols on the
+      board (`NOUGHT` when equal) as noughts always move first.
+    * Scores are stored as the moves until the game ends (positive for a win,
+      negative for a loss and `0` for a draw) so each entry stays 2 bytes.
+*/
+
+
+#ifndef _BOOK_H
+    #define _BOOK_H
+
+    #include <stdbool.h>
+    #include <stdint.h>
+
+    #include "board.h"
+    #include "score.h"
+
+
+    // book only holds standard 3x3 states
+    static const uint8_t BOOK_SIZE = 3;
+
+    // 3 to the power of the number of cells
+    #define BOOK_ENTRIES 19683
+
+    // move of terminal and unreachable states
+    static const uint8_t BOOK_MOVE_NONE = UINT8_MAX;
+
+
+    typedef struct
+    {
+        uint8_t move;
+        int8_t distance;
+    } bookentry_t;
+
+
+    bool lookupBook(board_t *board,
+                    char     symbolSelf,
+                    uint8_t *move,
+                    score_t *score);
+
+    uint16_t getBookIndex(board_t *board);
+
+#endif
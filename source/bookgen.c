@@ -0,0 +1,136 @@
+/*
+@context
+    * Generates the opening book of every reachable 3x3 state.
+    * Every state is solved at once by retrograde analysis (`retrograde.h`)
+      and printed as a `bookentry_t` initialiser in the order of
+      `getBookIndex`.
+    * Built and run by `make` to create `book.inc` (`./bookgen > book.inc`).
+*/
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "board.h"
+#include "book.h"
+#include "retrograde.h"
+
+
+static bool setState(board_t  *board,
+                     uint16_t  index,
+                     char     *symbol);
+
+
+/*
+@context
+    * Entry point of program.
+    * Prints the book entry of every state in index order.
+
+@return
+    * Indicates program successfully terminates.
+*/
+int main()
+{
+    retrograde_t *retrograde;
+    board_t *board;
+    bookentry_t entry;
+    score_t score;
+    uint16_t index;
+    char symbol;
+
+    board = initBoard(BOOK_SIZE);
+    retrograde = solveRetrograde(BOOK_SIZE, BOOK_SIZE, 1);
+
+    for (index = 0; index < BOOK_ENTRIES; index += 1)
+    {
+        entry.move = BOOK_MOVE_NONE;
+        entry.distance = 0;
+
+        // only reachable states which have not ended have a move
+        if (setState(board, index, &symbol)
+            && lookupRetrograde(retrograde, board, symbol, &entry.move, &score))
+        {
+            // stored as the moves until the game ends (see `book.h`)
+            if (score > SCORE_EVAL_MAX)
+            {
+                entry.distance = SCORE_WIN - score;
+            }
+            else if (score < -SCORE_EVAL_MAX)
+            {
+                entry.distance = SCORE_LOSE - score;
+            }
+        }
+
+        printf("{%d, %d},\n", entry.move, entry.distance);
+    }
+
+    freeRetrograde(retrograde);
+    freeBoard(board);
+
+    return EXIT_SUCCESS;
+}
+
+
+/*
+@context
+    * Sets `board` to the state at `index` within the book.
+    * Determines if the state can be reached by a game.
+
+@parameters
+    * board
+        * 3x3 board to set the cells of.
+    * index
+        * Index of the state within the book.
+    * symbol
+        * Set to the symbol to move next within the state.
+
+@return
+    * Indicates if the state can be reached by a game.
+*/
+static bool setState(board_t  *board,
+                     uint16_t  index,
+                     char     *symbol)
+{
+    uint8_t cell, noughts, crosses;
+
+    resetBoard(board);
+    noughts = 0;
+    crosses = 0;
+
+    for (cell = 0; cell < BOOK_SIZE * BOOK_SIZE; cell += 1)
+    {
+        if (index % 3 == 1)
+        {
+            setCell(board, cell, NOUGHT);
+            noughts += 1;
+        }
+        else if (index % 3 == 2)
+        {
+            setCell(board, cell, CROSS);
+            crosses += 1;
+        }
+        index /= 3;
+    }
+
+    *symbol = noughts == crosses ? NOUGHT : CROSS;
+
+    // noughts move first so have the same or 1 more symbol than crosses
+    if (noughts != crosses && noughts != crosses + 1)
+    {
+        return false;
+    }
+
+    // game ends at the first win which must be from the last symbol to move
+    if (isWin(board, NOUGHT) && (isWin(board, CROSS) || *symbol != CROSS))
+    {
+        return false;
+    }
+    if (isWin(board, CROSS) && *symbol != NOUGHT)
+    {
+        return false;
+    }
+
+    return true;
+}
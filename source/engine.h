@@ -0,0 +1,51 @@
+/*
+@context
+    * Provides the whole engine through 1 header - included by programs which
+      embed the engine (linked with `libminimax.a` or `libminimax.so` from
+      `make lib`) instead of running the interactive program.
+        * Boards to play on (`board.h`) and positions to store them compactly
+          (`position.h`).
+        * Best moves of a board (`minimax.h` - by engines of their own which
+          can search at once from any thread) or of many positions at once
+          (`batch.h`) with their scores (`score.h`) and statistics of
+          searches (`stats.h`).
+        * Proofs of forced wins before searching (`proof.h`).
+        * Databases of every state of boards of up to 16 cells solved by
+          retrograde analysis so their moves are only looked up
+          (`retrograde.h`).
+        * Monte Carlo tree search of boards too large to search with minimax
+          (`mcts.h`).
+    * Can be included from C++ - every function has C linkage.
+    * `ENGINE_VERSION` is increased whenever a function of the engine changes
+      so programs can check which engine they were built against.
+*/
+
+
+#ifndef _ENGINE_H
+    #define _ENGINE_H
+
+    #include <stdint.h>
+
+    #ifdef __cplusplus
+    extern "C"
+    {
+    #endif
+
+        #include "batch.h"
+        #include "board.h"
+        #include "mcts.h"
+        #include "minimax.h"
+        #include "position.h"
+        #include "proof.h"
+        #include "retrograde.h"
+        #include "score.h"
+        #include "stats.h"
+
+
+        static const uint16_t ENGINE_VERSION = 6;
+
+    #ifdef __cplusplus
+    }
+    #endif
+
+#endif
@@ -0,0 +1,711 @@
+#include "lines.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+    #define LINES_AVX2
+    #include <immintrin.h>
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+    #define LINES_NEON
+    #include <arm_neon.h>
+#endif
+
+
+// bits between a cell and the next cell along each direction - right, down
+// and both diagonals (the unset bits past each row stop lines wrapping)
+#define LINES_DIRECTIONS 4
+
+static const uint8_t DIRECTION_SHIFTS[LINES_DIRECTIONS] =
+{
+    1, BITBOARD_STRIDE, BITBOARD_STRIDE + 1, BITBOARD_STRIDE - 1
+};
+
+// longer than any line of a board
+#define LINES_MAX_LENGTH BITBOARD_STRIDE
+
+
+static bool hasLineScalar(const bitboard_t *stones,
+                          uint8_t           length);
+static void getCompletionsScalar(const bitboard_t *stones,
+                                 const bitboard_t *empty,
+                                 uint8_t           length,
+                                 bitboard_t       *cells);
+static void shiftDown(bitboard_t *bitboard,
+                      uint8_t     shift);
+static void shiftUp(bitboard_t *bitboard,
+                    uint8_t     shift);
+
+#ifdef LINES_AVX2
+    static bool hasLineAvx2(const bitboard_t *stones,
+                            uint8_t           length);
+    static void getCompletionsAvx2(const bitboard_t *stones,
+                                   const bitboard_t *empty,
+                                   uint8_t           length,
+                                   bitboard_t       *cells);
+#endif
+
+#ifdef LINES_NEON
+    static bool hasLineNeon(const bitboard_t *stones,
+                            uint8_t           length);
+    static void getCompletionsNeon(const bitboard_t *stones,
+                                   const bitboard_t *empty,
+                                   uint8_t           length,
+                                   bitboard_t       *cells);
+#endif
+
+
+// kernel used by every call - every CPU of an architecture has its baseline
+// kernel so only wider kernels are chosen by `initLines`
+#ifdef LINES_NEON
+    static bool (*hasLineKernel)(const bitboard_t *, uint8_t) = hasLineNeon;
+    static void (*getCompletionsKernel)(const bitboard_t *,
+                                        const bitboard_t *,
+                                        uint8_t,
+                                        bitboard_t *) = getCompletionsNeon;
+    static const char *kernelName = "neon";
+#else
+    static bool (*hasLineKernel)(const bitboard_t *, uint8_t) = hasLineScalar;
+    static void (*getCompletionsKernel)(const bitboard_t *,
+                                        const bitboard_t *,
+                                        uint8_t,
+                                        bitboard_t *) = getCompletionsScalar;
+    static const char *kernelName = "scalar";
+#endif
+
+
+/* ------------------------------ START PUBLIC ------------------------------ */
+
+
+/*
+@context
+    * Chooses the widest kernel the CPU supports.
+    * Must be called before any other thread detects lines - called by the
+      first board initialised so never needs calling otherwise.
+*/
+void initLines()
+{
+#ifdef LINES_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        hasLineKernel = hasLineAvx2;
+        getCompletionsKernel = getCompletionsAvx2;
+        kernelName = "avx2";
+    }
+#endif
+}
+
+
+/*
+@context
+    * Gets the name of the kernel chosen by `initLines`.
+
+@return
+    * `avx2`, `neon` or `scalar`.
+*/
+const char *getLinesKernel()
+{
+    return kernelName;
+}
+
+
+/*
+@context
+    * Determines if `stones` fill `length` consecutive cells of any row,
+      column or diagonal.
+
+@parameters
+    * stones
+        * Cells of a symbol.
+    * length
+        * Number of consecutive cells of a line (`1` to `BOARD_MAX_SIZE`).
+
+@return
+    * Indicates if `stones` have a line of `length`.
+*/
+bool hasLine(const bitboard_t *stones,
+             uint8_t           length)
+{
+    return hasLineKernel(stones, length);
+}
+
+
+/*
+@context
+    * Gets every cell of `empty` which gives `stones` a line of `length` if
+      filled - the cells which win next move.
+    * Each cell completes a line when the cells before it along a direction
+      and the cells after it are together `length - 1` stones.
+
+@parameters
+    * stones
+        * Cells of a symbol.
+    * empty
+        * Empty cells of the board of `stones`.
+    * length
+        * Number of consecutive cells of a line (`1` to `BOARD_MAX_SIZE`).
+    * cells
+        * Set to every cell which completes a line.
+*/
+void getCompletions(const bitboard_t *stones,
+                    const bitboard_t *empty,
+                    uint8_t           length,
+                    bitboard_t       *cells)
+{
+    getCompletionsKernel(stones, empty, length, cells);
+}
+
+
+/* ------------------------------- END PUBLIC ------------------------------- */
+/* ----------------------------- START  PRIVATE ----------------------------- */
+
+
+/*
+@context
+    * Determines if `stones` have a line of `length` 1 word at a time.
+    * Each direction keeps the cells which start a run, 1 cell longer each
+      shift, until the run is `length` or none are left.
+
+@parameters
+    * stones
+        * Cells of a symbol.
+    * length
+        * Number of consecutive cells of a line.
+
+@return
+    * Indicates if `stones` have a line of `length`.
+*/
+static bool hasLineScalar(const bitboard_t *stones,
+                          uint8_t           length)
+{
+    bitboard_t runs;
+    uint8_t direction, run, i;
+
+    for (direction = 0; direction < LINES_DIRECTIONS; direction += 1)
+    {
+        runs = *stones;
+        for (run = 1; run < length && !isBitboardEmpty(&runs); run += 1)
+        {
+            shiftDown(&runs, DIRECTION_SHIFTS[direction]);
+            for (i = 0; i < BITBOARD_WORDS; i += 1)
+            {
+                runs.words[i] &= stones->words[i];
+            }
+        }
+
+        if (!isBitboardEmpty(&runs))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/*
+@context
+    * Gets the cells which complete a line of `stones` 1 word at a time.
+    * `after[n]` are the cells followed by `n` stones along a direction and
+      `before[n]` the cells preceded by `n` stones.
+
+@parameters
+    * stones
+        * Cells of a symbol.
+    * empty
+        * Empty cells of the board of `stones`.
+    * length
+        * Number of consecutive cells of a line.
+    * cells
+        * Set to every cell which completes a line.
+*/
+static void getCompletionsScalar(const bitboard_t *stones,
+                                 const bitboard_t *empty,
+                                 uint8_t           length,
+                                 bitboard_t       *cells)
+{
+    bitboard_t after[LINES_MAX_LENGTH], before[LINES_MAX_LENGTH];
+    uint8_t direction, run, i;
+
+    clearBitboard(cells);
+    for (direction = 0; direction < LINES_DIRECTIONS; direction += 1)
+    {
+        for (i = 0; i < BITBOARD_WORDS; i += 1)
+        {
+            after[0].words[i] = UINT64_MAX;
+            before[0].words[i] = UINT64_MAX;
+        }
+
+        for (run = 1; run < length; run += 1)
+        {
+            for (i = 0; i < BITBOARD_WORDS; i += 1)
+            {
+                after[run].words[i] = after[run - 1].words[i]
+                    & stones->words[i];
+                before[run].words[i] = before[run - 1].words[i]
+                    & stones->words[i];
+            }
+            shiftDown(&after[run], DIRECTION_SHIFTS[direction]);
+            shiftUp(&before[run], DIRECTION_SHIFTS[direction]);
+        }
+
+        for (run = 0; run < length; run += 1)
+        {
+            for (i = 0; i < BITBOARD_WORDS; i += 1)
+            {
+                cells->words[i] |= after[run].words[i]
+                    & before[length - 1 - run].words[i];
+            }
+        }
+    }
+
+    for (i = 0; i < BITBOARD_WORDS; i += 1)
+    {
+        cells->words[i] &= empty->words[i];
+    }
+}
+
+
+/*
+@context
+    * Moves every bit of `bitboard` `shift` bits lower (the bit of each cell
+      moves to the cell `shift` bits before it).
+
+@parameters
+    * bitboard
+        * Bitboard to shift.
+    * shift
+        * Bits to shift by (`1` to `63`).
+*/
+static void shiftDown(bitboard_t *bitboard,
+                      uint8_t     shift)
+{
+    uint8_t i;
+
+    for (i = 0; i + 1 < BITBOARD_WORDS; i += 1)
+    {
+        bitboard->words[i] = (bitboard->words[i] >> shift)
+            | (bitboard->words[i + 1] << (64 - shift));
+    }
+    bitboard->words[BITBOARD_WORDS - 1] >>= shift;
+}
+
+
+/*
+@context
+    * Moves every bit of `bitboard` `shift` bits higher.
+
+@parameters
+    * bitboard
+        * Bitboard to shift.
+    * shift
+        * Bits to shift by (`1` to `63`).
+*/
+static void shiftUp(bitboard_t *bitboard,
+                    uint8_t     shift)
+{
+    uint8_t i;
+
+    for (i = BITBOARD_WORDS - 1; i > 0; i -= 1)
+    {
+        bitboard->words[i] = (bitboard->words[i] << shift)
+            | (bitboard->words[i - 1] >> (64 - shift));
+    }
+    bitboard->words[0] <<= shift;
+}
+
+
+#ifdef LINES_AVX2
+
+
+/*
+@context
+    * Moves every bit of a bitboard within 1 register `shift` bits lower.
+    * Each word takes the low bits of the word above it (the words rotated
+      down 1 with the highest cleared).
+
+@parameters
+    * bits
+        * Every word of a bitboard.
+    * shift
+        * Bits to shift by (`1` to `63`).
+
+@return
+    * Shifted bitboard.
+*/
+__attribute__((target("avx2")))
+static inline __m256i shiftDownAvx2(__m256i bits,
+                                    uint8_t shift)
+{
+    __m256i above;
+
+    above = _mm256_permute4x64_epi64(bits, _MM_SHUFFLE(0, 3, 2, 1));
+    above = _mm256_blend_epi32(above, _mm256_setzero_si256(), 0xC0);
+
+    return _mm256_or_si256(
+        _mm256_srl_epi64(bits, _mm_cvtsi32_si128(shift)),
+        _mm256_sll_epi64(above, _mm_cvtsi32_si128(64 - shift)));
+}
+
+
+/*
+@context
+    * Moves every bit of a bitboard within 1 register `shift` bits higher.
+    * Each word takes the high bits of the word below it (the words rotated
+      up 1 with the lowest cleared).
+
+@parameters
+    * bits
+        * Every word of a bitboard.
+    * shift
+        * Bits to shift by (`1` to `63`).
+
+@return
+    * Shifted bitboard.
+*/
+__attribute__((target("avx2")))
+static inline __m256i shiftUpAvx2(__m256i bits,
+                                  uint8_t shift)
+{
+    __m256i below;
+
+    below = _mm256_permute4x64_epi64(bits, _MM_SHUFFLE(2, 1, 0, 3));
+    below = _mm256_blend_epi32(below, _mm256_setzero_si256(), 0x03);
+
+    return _mm256_or_si256(
+        _mm256_sll_epi64(bits, _mm_cvtsi32_si128(shift)),
+        _mm256_srl_epi64(below, _mm_cvtsi32_si128(64 - shift)));
+}
+
+
+/*
+@context
+    * Determines if `stones` have a line of `length` with AVX2 (same as
+      `hasLineScalar`).
+
+@parameters
+    * stones
+        * Cells of a symbol.
+    * length
+        * Number of consecutive cells of a line.
+
+@return
+    * Indicates if `stones` have a line of `length`.
+*/
+__attribute__((target("avx2")))
+static bool hasLineAvx2(const bitboard_t *stones,
+                        uint8_t           length)
+{
+    __m256i bits, runs;
+    uint8_t direction, run;
+
+    bits = _mm256_loadu_si256((const __m256i *)stones->words);
+    for (direction = 0; direction < LINES_DIRECTIONS; direction += 1)
+    {
+        runs = bits;
+        for (run = 1; run < length && !_mm256_testz_si256(runs, runs);
+             run += 1)
+        {
+            runs = _mm256_and_si256(
+                shiftDownAvx2(runs, DIRECTION_SHIFTS[direction]),
+                bits);
+        }
+
+        if (!_mm256_testz_si256(runs, runs))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/*
+@context
+    * Gets the cells which complete a line of `stones` with AVX2 (same as
+      `getCompletionsScalar`).
+
+@parameters
+    * stones
+        * Cells of a symbol.
+    * empty
+        * Empty cells of the board of `stones`.
+    * length
+        * Number of consecutive cells of a line.
+    * cells
+        * Set to every cell which completes a line.
+*/
+__attribute__((target("avx2")))
+static void getCompletionsAvx2(const bitboard_t *stones,
+                               const bitboard_t *empty,
+                               uint8_t           length,
+                               bitboard_t       *cells)
+{
+    __m256i after[LINES_MAX_LENGTH], before[LINES_MAX_LENGTH];
+    __m256i bits, found;
+    uint8_t direction, run;
+
+    bits = _mm256_loadu_si256((const __m256i *)stones->words);
+    found = _mm256_setzero_si256();
+    for (direction = 0; direction < LINES_DIRECTIONS; direction += 1)
+    {
+        after[0] = _mm256_set1_epi64x(-1);
+        before[0] = after[0];
+
+        for (run = 1; run < length; run += 1)
+        {
+            after[run] = shiftDownAvx2(_mm256_and_si256(after[run - 1], bits),
+                                       DIRECTION_SHIFTS[direction]);
+            before[run] = shiftUpAvx2(_mm256_and_si256(before[run - 1], bits),
+                                      DIRECTION_SHIFTS[direction]);
+        }
+
+        for (run = 0; run < length; run += 1)
+        {
+            found = _mm256_or_si256(
+                found,
+                _mm256_and_si256(after[run], before[length - 1 - run]));
+        }
+    }
+
+    found = _mm256_and_si256(
+        found,
+        _mm256_loadu_si256((const __m256i *)empty->words));
+    _mm256_storeu_si256((__m256i *)cells->words, found);
+}
+
+
+#endif
+
+
+#ifdef LINES_NEON
+
+
+// every word of a bitboard within 2 registers (lowest words first)
+typedef struct
+{
+    uint64x2_t low;
+    uint64x2_t high;
+} neonbits_t;
+
+
+/*
+@context
+    * Moves every bit of a bitboard within 2 registers `shift` bits lower.
+    * Each word takes the low bits of the word above it.
+
+@parameters
+    * bits
+        * Every word of a bitboard.
+    * shift
+        * Bits to shift by (`1` to `63`).
+
+@return
+    * Shifted bitboard.
+*/
+static inline neonbits_t shiftDownNeon(neonbits_t bits,
+                                       uint8_t    shift)
+{
+    neonbits_t shifted;
+    int64x2_t down, up;
+
+    // negative shifts of `vshlq_u64` shift right
+    down = vdupq_n_s64(-(int64_t)shift);
+    up = vdupq_n_s64(64 - shift);
+
+    shifted.low = vorrq_u64(vshlq_u64(bits.low, down),
+                            vshlq_u64(vextq_u64(bits.low, bits.high, 1), up));
+    shifted.high = vorrq_u64(vshlq_u64(bits.high, down),
+                             vshlq_u64(vextq_u64(bits.high,
+                                                 vdupq_n_u64(0),
+                                                 1),
+                                       up));
+
+    return shifted;
+}
+
+
+/*
+@context
+    * Moves every bit of a bitboard within 2 registers `shift` bits higher.
+    * Each word takes the high bits of the word below it.
+
+@parameters
+    * bits
+        * Every word of a bitboard.
+    * shift
+        * Bits to shift by (`1` to `63`).
+
+@return
+    * Shifted bitboard.
+*/
+static inline neonbits_t shiftUpNeon(neonbits_t bits,
+                                     uint8_t    shift)
+{
+    neonbits_t shifted;
+    int64x2_t up, down;
+
+    up = vdupq_n_s64(shift);
+    down = vdupq_n_s64(-(int64_t)(64 - shift));
+
+    shifted.low = vorrq_u64(vshlq_u64(bits.low, up),
+                            vshlq_u64(vextq_u64(vdupq_n_u64(0),
+                                                bits.low,
+                                                1),
+                                      down));
+    shifted.high = vorrq_u64(vshlq_u64(bits.high, up),
+                             vshlq_u64(vextq_u64(bits.low, bits.high, 1),
+                                       down));
+
+    return shifted;
+}
+
+
+/*
+@context
+    * Gets the bits set in both `a` and `b`.
+
+@parameters
+    * a
+        * First bitboard.
+    * b
+        * Second bitboard.
+
+@return
+    * Intersection of `a` and `b`.
+*/
+static inline neonbits_t andNeon(neonbits_t a,
+                                 neonbits_t b)
+{
+    neonbits_t bits;
+
+    bits.low = vandq_u64(a.low, b.low);
+    bits.high = vandq_u64(a.high, b.high);
+
+    return bits;
+}
+
+
+/*
+@context
+    * Determines if no bit of `bits` is set.
+
+@parameters
+    * bits
+        * Bitboard to check.
+
+@return
+    * Indicates if `bits` is empty.
+*/
+static inline bool isEmptyNeon(neonbits_t bits)
+{
+    uint64x2_t any;
+
+    any = vorrq_u64(bits.low, bits.high);
+    return (vgetq_lane_u64(any, 0) | vgetq_lane_u64(any, 1)) == 0;
+}
+
+
+/*
+@context
+    * Determines if `stones` have a line of `length` with NEON (same as
+      `hasLineScalar`).
+
+@parameters
+    * stones
+        * Cells of a symbol.
+    * length
+        * Number of consecutive cells of a line.
+
+@return
+    * Indicates if `stones` have a line of `length`.
+*/
+static bool hasLineNeon(const bitboard_t *stones,
+                        uint8_t           length)
+{
+    neonbits_t bits, runs;
+    uint8_t direction, run;
+
+    bits.low = vld1q_u64(&stones->words[0]);
+    bits.high = vld1q_u64(&stones->words[2]);
+    for (direction = 0; direction < LINES_DIRECTIONS; direction += 1)
+    {
+        runs = bits;
+        for (run = 1; run < length && !isEmptyNeon(runs); run += 1)
+        {
+            runs = andNeon(shiftDownNeon(runs, DIRECTION_SHIFTS[direction]),
+                           bits);
+        }
+
+        if (!isEmptyNeon(runs))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/*
+@context
+    * Gets the cells which complete a line of `stones` with NEON (same as
+      `getCompletionsScalar`).
+
+@parameters
+    * stones
+        * Cells of a symbol.
+    * empty
+        * Empty cells of the board of `stones`.
+    * length
+        * Number of consecutive cells of a line.
+    * cells
+        * Set to every cell which completes a line.
+*/
+static void getCompletionsNeon(const bitboard_t *stones,
+                               const bitboard_t *empty,
+                               uint8_t           length,
+                               bitboard_t       *cells)
+{
+    neonbits_t after[LINES_MAX_LENGTH], before[LINES_MAX_LENGTH];
+    neonbits_t bits, found, both;
+    uint8_t direction, run;
+
+    bits.low = vld1q_u64(&stones->words[0]);
+    bits.high = vld1q_u64(&stones->words[2]);
+    found.low = vdupq_n_u64(0);
+    found.high = found.low;
+    for (direction = 0; direction < LINES_DIRECTIONS; direction += 1)
+    {
+        after[0].low = vdupq_n_u64(UINT64_MAX);
+        after[0].high = after[0].low;
+        before[0] = after[0];
+
+        for (run = 1; run < length; run += 1)
+        {
+            after[run] = shiftDownNeon(andNeon(after[run - 1], bits),
+                                       DIRECTION_SHIFTS[direction]);
+            before[run] = shiftUpNeon(andNeon(before[run - 1], bits),
+                                      DIRECTION_SHIFTS[direction]);
+        }
+
+        for (run = 0; run < length; run += 1)
+        {
+            both = andNeon(after[run], before[length - 1 - run]);
+            found.low = vorrq_u64(found.low, both.low);
+            found.high = vorrq_u64(found.high, both.high);
+        }
+    }
+
+    vst1q_u64(&cells->words[0],
+              vandq_u64(found.low, vld1q_u64(&empty->words[0])));
+    vst1q_u64(&cells->words[2],
+              vandq_u64(found.high, vld1q_u64(&empty->words[2])));
+}
+
+
+#endif
+
+
+/* ------------------------------ END  PRIVATE ------------------------------ */
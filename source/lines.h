@@ -0,0 +1,39 @@
+/*
+@context
+    * Provides win and threat detection over whole bitboards - every window
+      of every row, column and diagonal at once instead of 1 at a time.
+        * A line of `length` is found by shifting a bitboard 1 cell along a
+          direction and ANDing it `length - 1` times.
+        * Cells which complete a line are found by ANDing the runs of cells
+          before and after each cell.
+    * Used where boards are too many or too short lived to keep the window
+      counts of a board (playouts and move generation).
+    * Bitboards are processed by the widest kernel the CPU supports - chosen
+      once by `initLines` (every kernel gives the same results).
+        * `avx2` - every word of a bitboard within 1 register (x86-64 with
+          AVX2, detected at runtime).
+        * `neon` - 2 words to a register (AArch64).
+        * `scalar` - 1 word at a time (any other CPU).
+*/
+
+
+#ifndef _LINES_H
+    #define _LINES_H
+
+    #include <stdbool.h>
+    #include <stdint.h>
+
+    #include "bitboard.h"
+
+
+    void initLines();
+    const char *getLinesKernel();
+
+    bool hasLine(const bitboard_t *stones,
+                 uint8_t           length);
+    void getCompletions(const bitboard_t *stones,
+                        const bitboard_t *empty,
+                        uint8_t           length,
+                        bitboard_t       *cells);
+
+#endif
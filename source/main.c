@@ -4,6 +4,8 @@
     * Allows the user to play standard 3x3 Noughts and Crosses games against an
       optimal AI.
         * User can never win only ever draw or lose.
+    * Runs the non-interactive engine mode instead when the first argument is
+      `--engine` (see `server.h`).
 */
 
 
@@ -12,16 +14,21 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "board.h"
 #include "interface.h"
 #include "minimax.h"
+#include "server.h"
 
 
 static const char KEY_QUIT = 'q';
 static const char KEY_YES = 'y';
 static const char KEY_NO = 'n';
 
+// entries of the transposition table shared by every AI move
+static const uint32_t TABLE_SIZE = 1 << 16;
+
 
 static void play(board_t *board);
 static bool turn(board_t *board,
@@ -52,22 +59,38 @@ static char getInputLoop(board_t *board,
 @context
     * Entry point of program.
     * Creates the interface and plays Noughts and Crosses game until user quits.
+    * Runs the engine mode instead if the first argument is `ARG_ENGINE`.
+
+@parameters
+    * argc
+        * Number of arguments.
+    * argv
+        * Name of the program then `ARG_ENGINE` and its options (if any).
 
 @return
     * Indicates program successfully terminates.
 */
-int main()
+int main(int   argc,
+         char *argv[])
 {
     board_t *board;
 
+    // engine mode does not use the interface
+    if (argc > 1 && strcmp(argv[1], ARG_ENGINE) == 0)
+    {
+        return runServer(argc - 2, argv + 2) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
     // initialise interface and play games until user quits
     if (initInterface())
     {
         board = initBoard(BOARD_SIZE);
+        initMinimax(TABLE_SIZE);
 
         play(board);
 
         freeInterface();
+        freeMinimax();
         freeBoard(board);
     }
 
@@ -185,7 +208,10 @@ static bool moveUser(board_t *board,
     int cell;
 
     // get user input - may quit current game
+    // the AI searches the user's moves while waiting so it replies sooner
+    startPondering(board, symbolUser);
     input = getInputLoop(board, symbolUser, false, true);
+    stopPondering();
     if (input == KEY_QUIT)
     {
         updateMessage(MSG_REPLAY);
@@ -0,0 +1,728 @@
+#include "mcts.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <threads.h>
+
+#include "bitboard.h"
+#include "lines.h"
+#include "ordering.h"
+#include "timer.h"
+
+
+// no move made (the root of the tree)
+static const uint8_t MOVE_NONE = UINT8_MAX;
+
+// UCT exploration weight - square root of 2 for results between 0 and 1
+static const double EXPLORATION = 1.41421356237;
+
+// points of a playout for the symbol which made the move of a state
+// (half points so a draw is whole)
+static const uint8_t POINTS_WIN = 2;
+static const uint8_t POINTS_DRAW = 1;
+static const uint8_t POINTS_LOSS = 0;
+
+// random moves of thread `i` start from `SEED` mixed with `i`
+static const uint64_t SEED = 0x9E3779B97F4A7C15;
+
+
+// state of the tree - the children of a state are next to each other
+typedef struct
+{
+    // playouts through the state (including those still being made) and
+    // the points of them for the symbol which made `move`
+    uint64_t points;
+    uint32_t visits;
+
+    // index of the first child (`0` until expanded - the root is never a
+    // child) and number of children
+    uint32_t firstChild;
+    uint8_t childCount;
+
+    uint8_t move;
+} mctsnode_t;
+
+// tree shared by every thread of a search
+typedef struct
+{
+    // arena of states - `used` are allocated and the root is first
+    mctsnode_t *nodes;
+    uint32_t capacity;
+    uint32_t used;
+
+    char symbolSelf;
+    uint8_t playout;
+
+    // playouts started and the limits which stop the search once passed
+    uint64_t playouts;
+    uint64_t maxPlayouts;
+    uint64_t deadline;
+    bool isStopped;
+
+    // held while selecting, expanding and updating (not during playouts)
+    mtx_t lock;
+} tree_t;
+
+// thread of a search - each makes moves on its own copy of the board
+// (within the worker so copies are not allocated)
+typedef struct
+{
+    thrd_t thread;
+    bool isStarted;
+    boardstorage_t storage;
+    board_t *board;
+    tree_t *tree;
+
+    // state of the random moves of the thread (xorshift)
+    uint64_t random;
+} worker_t;
+
+
+static int runWorker(void *worker);
+static bool searchTree(worker_t *worker);
+static uint32_t selectChild(tree_t     *tree,
+                            mctsnode_t *node);
+static void expandNode(tree_t  *tree,
+                       board_t *board,
+                       char     symbol,
+                       uint32_t index);
+static uint8_t getMoves(board_t *board,
+                        char     symbol,
+                        uint8_t  moves[]);
+
+static char playRandom(worker_t *worker,
+                       char      symbol);
+static uint8_t getPlayoutMove(worker_t         *worker,
+                              const bitboard_t  stones[],
+                              const bitboard_t *empty,
+                              uint8_t           side,
+                              const uint16_t    bits[],
+                              uint8_t           count);
+static uint64_t getRandom(uint64_t *state);
+
+static score_t getScore(board_t          *board,
+                        char              symbolSelf,
+                        const mctsnode_t *node);
+
+
+/* ------------------------------ START PUBLIC ------------------------------ */
+
+
+/*
+@context
+    * Finds a good move of `board` for `symbolSelf` by Monte Carlo tree
+      search - the move played out the most.
+
+@parameters
+    * board
+        * Current state of the Noughts and Crosses game (not ended).
+        * Unchanged once returned (each thread makes moves on a copy).
+    * symbolSelf
+        * Symbol to move next.
+    * limits
+        * Most playouts (`nodes` - of every thread) and time to search.
+        * At least 1 limit is required (`0` for no limit) - depth is not
+          limited as every playout ends with its game.
+    * memory
+        * Most bytes of the arena of the tree.
+        * States stop being added once full.
+    * threads
+        * Number of threads sharing the tree.
+        * `0` and `1` search without starting a thread.
+    * playout
+        * How playouts move after leaving the tree (`MCTS_RANDOM` or
+          `MCTS_HEURISTIC`).
+    * score
+        * Set to the score of the move - its playout results scaled within
+          the heuristic scores (`SCORE_EVAL_MAX` if every playout won) or a
+          win if the move wins.
+
+@return
+    * Cell of the move played out the most.
+    * First move of the tree if no playout finished.
+*/
+uint8_t getBestMoveMCTS(board_t        *board,
+                        char            symbolSelf,
+                        const limits_t *limits,
+                        size_t          memory,
+                        uint8_t         threads,
+                        uint8_t         playout,
+                        score_t        *score)
+{
+    tree_t tree;
+    worker_t *workers;
+    mctsnode_t *root, *best;
+    uint8_t moves[BOARD_MAX_SIZE * BOARD_MAX_SIZE];
+    uint64_t count;
+    uint32_t child;
+    uint8_t i;
+
+    assert(!isWin(board, NOUGHT) && !isWin(board, CROSS) && !isFull(board));
+    assert(limits->nodes > 0 || limits->time > 0);
+
+    threads = threads > 1 ? threads : 1;
+
+    // the root and its children must fit for a move to be chosen
+    count = memory / sizeof(mctsnode_t);
+    tree.capacity = count < UINT32_MAX ? count : UINT32_MAX;
+    if (tree.capacity < 1 + (BOARD_MAX_SIZE * BOARD_MAX_SIZE))
+    {
+        tree.capacity = 1 + (BOARD_MAX_SIZE * BOARD_MAX_SIZE);
+    }
+    tree.nodes = malloc(sizeof(mctsnode_t) * tree.capacity);
+    assert(tree.nodes != NULL);
+
+    root = &tree.nodes[0];
+    root->points = 0;
+    root->visits = 0;
+    root->firstChild = 0;
+    root->childCount = 0;
+    root->move = MOVE_NONE;
+    tree.used = 1;
+
+    tree.symbolSelf = symbolSelf;
+    tree.playout = playout;
+
+    tree.playouts = 0;
+    tree.maxPlayouts = limits->nodes;
+    tree.deadline = 0;
+    if (limits->time > 0)
+    {
+        tree.deadline = getTime() + (limits->time * NS_PER_MS);
+    }
+    tree.isStopped = false;
+    mtx_init(&tree.lock, mtx_plain);
+
+    workers = malloc(sizeof(worker_t) * threads);
+    assert(workers != NULL);
+
+    for (i = 0; i < threads; i += 1)
+    {
+        workers[i].board = copyBoard(board, &workers[i].storage);
+        workers[i].tree = &tree;
+        workers[i].random = (SEED ^ (i * 0xBF58476D1CE4E5B9)) | 1;
+    }
+
+    // playouts of a thread which fails to start are made by the others
+    for (i = 1; i < threads; i += 1)
+    {
+        workers[i].isStarted = thrd_create(&workers[i].thread,
+                                           runWorker,
+                                           &workers[i]) == thrd_success;
+    }
+    runWorker(&workers[0]);
+
+    for (i = 1; i < threads; i += 1)
+    {
+        if (workers[i].isStarted)
+        {
+            thrd_join(workers[i].thread, NULL);
+        }
+    }
+
+    // most played out is more reliable than the best average
+    best = NULL;
+    for (child = root->firstChild;
+         root->firstChild > 0 && child < root->firstChild + root->childCount;
+         child += 1)
+    {
+        if (best == NULL || tree.nodes[child].visits > best->visits)
+        {
+            best = &tree.nodes[child];
+        }
+    }
+
+    if (best == NULL)
+    {
+        getMoves(board, symbolSelf, moves);
+        *score = SCORE_DRAW;
+        child = moves[0];
+    }
+    else
+    {
+        *score = getScore(board, symbolSelf, best);
+        child = best->move;
+    }
+
+    mtx_destroy(&tree.lock);
+    free(workers);
+    free(tree.nodes);
+
+    return child;
+}
+
+
+/* ------------------------------- END PUBLIC ------------------------------- */
+/* ----------------------------- START  PRIVATE ----------------------------- */
+
+
+/*
+@context
+    * Makes playouts until a limit of the search passes.
+    * Run by every thread of the search.
+
+@parameters
+    * worker
+        * Thread making the playouts.
+
+@return
+    * Always `0` (required by `thrd_create`).
+*/
+static int runWorker(void *worker)
+{
+    while (searchTree(worker));
+
+    return 0;
+}
+
+
+/*
+@context
+    * Makes 1 playout - selects states of the tree from the root by UCT,
+      expands the last, plays out the rest of the game and adds the result
+      to every state selected.
+    * Every state selected is visited before its playout is made so other
+      threads count it as a loss until the result is added.
+    * States are expanded on their second visit so states only visited once
+      do not fill the arena.
+
+@parameters
+    * worker
+        * Thread making the playout.
+
+@return
+    * Indicates if a playout was made (otherwise a limit has passed).
+*/
+static bool searchTree(worker_t *worker)
+{
+    tree_t *tree;
+    mctsnode_t *node;
+    uint32_t path[(BOARD_MAX_SIZE * BOARD_MAX_SIZE) + 1];
+    uint8_t depth, i;
+    char symbol, winner, mover;
+    bool isEnded;
+
+    tree = worker->tree;
+
+    mtx_lock(&tree->lock);
+    if (tree->isStopped
+        || (tree->maxPlayouts > 0 && tree->playouts >= tree->maxPlayouts)
+        || (tree->deadline > 0 && getTime() >= tree->deadline))
+    {
+        tree->isStopped = true;
+        mtx_unlock(&tree->lock);
+        return false;
+    }
+    tree->playouts += 1;
+
+    path[0] = 0;
+    tree->nodes[0].visits += 1;
+
+    depth = 0;
+    symbol = tree->symbolSelf;
+    winner = EMPTY;
+    isEnded = false;
+    while (true)
+    {
+        node = &tree->nodes[path[depth]];
+        if (node->firstChild == 0 && (depth == 0 || node->visits > 1))
+        {
+            expandNode(tree, worker->board, symbol, path[depth]);
+        }
+        if (node->firstChild == 0)
+        {
+            break;
+        }
+
+        path[depth + 1] = selectChild(tree, node);
+        node = &tree->nodes[path[depth + 1]];
+        node->visits += 1;
+
+        makeMove(worker->board, node->move, symbol);
+        depth += 1;
+
+        if (isWin(worker->board, symbol) || isFull(worker->board))
+        {
+            winner = isWin(worker->board, symbol) ? symbol : EMPTY;
+            isEnded = true;
+            break;
+        }
+        symbol = symbol == NOUGHT ? CROSS : NOUGHT;
+    }
+    mtx_unlock(&tree->lock);
+
+    if (!isEnded)
+    {
+        winner = playRandom(worker, symbol);
+    }
+
+    // the move of each state is made by the symbol not to move within it
+    mtx_lock(&tree->lock);
+    mover = tree->symbolSelf;
+    for (i = 1; i <= depth; i += 1)
+    {
+        tree->nodes[path[i]].points += winner == mover ? POINTS_WIN
+                                     : winner == EMPTY ? POINTS_DRAW
+                                     : POINTS_LOSS;
+        mover = mover == NOUGHT ? CROSS : NOUGHT;
+    }
+    mtx_unlock(&tree->lock);
+
+    for (i = 0; i < depth; i += 1)
+    {
+        unmakeMove(worker->board);
+    }
+
+    return true;
+}
+
+
+/*
+@context
+    * Selects the child of `node` to play out next by UCT - the highest
+      average result plus a bonus for children visited less than the rest.
+    * Children not yet visited are selected first (in their order).
+
+@parameters
+    * tree
+        * Tree `node` is within.
+    * node
+        * Expanded state to select a child of.
+
+@return
+    * Index of the selected child.
+*/
+static uint32_t selectChild(tree_t     *tree,
+                            mctsnode_t *node)
+{
+    const mctsnode_t *child;
+    uint32_t index, best;
+    double logVisits, value, bestValue;
+
+    logVisits = log(node->visits);
+
+    best = node->firstChild;
+    bestValue = -1;
+    for (index = node->firstChild;
+         index < node->firstChild + node->childCount;
+         index += 1)
+    {
+        child = &tree->nodes[index];
+        if (child->visits == 0)
+        {
+            return index;
+        }
+
+        value = ((double)child->points / (POINTS_WIN * child->visits))
+            + (EXPLORATION * sqrt(logVisits / child->visits));
+        if (value > bestValue)
+        {
+            best = index;
+            bestValue = value;
+        }
+    }
+
+    return best;
+}
+
+
+/*
+@context
+    * Adds every child of the state at `index` to the tree.
+    * Not expanded if the arena cannot fit every child.
+
+@parameters
+    * tree
+        * Tree to expand.
+    * board
+        * Board of the state to expand.
+    * symbol
+        * Symbol to move next within the state.
+    * index
+        * Index of the state to expand.
+*/
+static void expandNode(tree_t  *tree,
+                       board_t *board,
+                       char     symbol,
+                       uint32_t index)
+{
+    uint8_t moves[BOARD_MAX_SIZE * BOARD_MAX_SIZE];
+    mctsnode_t *child;
+    uint8_t count, i;
+
+    count = getMoves(board, symbol, moves);
+    if (tree->capacity - tree->used < count)
+    {
+        return;
+    }
+
+    for (i = 0; i < count; i += 1)
+    {
+        child = &tree->nodes[tree->used + i];
+        child->points = 0;
+        child->visits = 0;
+        child->firstChild = 0;
+        child->childCount = 0;
+        child->move = moves[i];
+    }
+
+    tree->nodes[index].firstChild = tree->used;
+    tree->nodes[index].childCount = count;
+    tree->used += count;
+}
+
+
+/*
+@context
+    * Gets the moves of `symbol` added to the tree as children.
+    * A winning move is the only child, otherwise moves blocking the
+      opponent's wins are the only children if there are any (as
+      `ORDER_FORCED`) - every other move loses sooner.
+    * Large boards otherwise only have cells near a filled cell (as
+      `ORDER_NEAR`).
+
+@parameters
+    * board
+        * Board to get the moves of (not ended).
+    * symbol
+        * Symbol to move.
+    * moves
+        * Filled with the cell of each move.
+        * Requires space for every cell of `board`.
+
+@return
+    * Number of `moves`.
+*/
+static uint8_t getMoves(board_t *board,
+                        char     symbol,
+                        uint8_t  moves[])
+{
+    uint8_t cell, count;
+
+    if (getWinningMoves(board, symbol, moves) > 0)
+    {
+        return 1;
+    }
+
+    count = getWinningMoves(board, symbol == NOUGHT ? CROSS : NOUGHT, moves);
+    if (count > 0)
+    {
+        return count;
+    }
+
+    if (getSize(board) >= ORDERING_NEAR_SIZE)
+    {
+        count = getNearMoves(board, ORDERING_NEAR_DISTANCE, moves);
+        if (count > 0)
+        {
+            return count;
+        }
+    }
+
+    count = 0;
+    for (cell = 0; cell < getSize(board) * getSize(board); cell += 1)
+    {
+        if (isValidMove(board, cell, symbol))
+        {
+            moves[count] = cell;
+            count += 1;
+        }
+    }
+
+    return count;
+}
+
+
+/*
+@context
+    * Plays the game of the board of `worker` to its end from a state which
+      has not ended.
+    * Moves are made on bitboards of the cells of each symbol instead of the
+      board - wins are found by `hasLine` rather than window counts which
+      cost more to update than a playout uses.
+
+@parameters
+    * worker
+        * Thread making the playout.
+        * Its board is unchanged.
+    * symbol
+        * Symbol to move next.
+
+@return
+    * Symbol which won the playout (`EMPTY` if drawn).
+*/
+static char playRandom(worker_t *worker,
+                       char      symbol)
+{
+    board_t *board;
+    bitboard_t stones[2], empty;
+    uint16_t bits[BOARD_MAX_SIZE * BOARD_MAX_SIZE];
+    uint8_t size, cell, count, index, side;
+
+    board = worker->board;
+    size = getSize(board);
+    getSymbolBitboard(board, NOUGHT, &stones[0]);
+    getSymbolBitboard(board, CROSS, &stones[1]);
+
+    // empty cells not yet played - a move swaps the last into its place
+    clearBitboard(&empty);
+    count = 0;
+    for (cell = 0; cell < size * size; cell += 1)
+    {
+        if (getCell(board, cell) == EMPTY)
+        {
+            bits[count] = getBit(cell / size, cell % size);
+            setBit(&empty, bits[count]);
+            count += 1;
+        }
+    }
+
+    side = symbol == NOUGHT ? 0 : 1;
+    while (count > 0)
+    {
+        index = getPlayoutMove(worker, stones, &empty, side, bits, count);
+        setBit(&stones[side], bits[index]);
+        unsetBit(&empty, bits[index]);
+
+        count -= 1;
+        bits[index] = bits[count];
+
+        if (hasLine(&stones[side], getLength(board)))
+        {
+            return side == 0 ? NOUGHT : CROSS;
+        }
+        side = 1 - side;
+    }
+
+    return EMPTY;
+}
+
+
+/*
+@context
+    * Gets the next move of a playout - a random empty cell.
+    * Heuristic playouts make a winning move or block a random winning move
+      of the opponent first when there are any.
+
+@parameters
+    * worker
+        * Thread making the playout.
+    * stones
+        * Cells of each symbol (noughts first).
+    * empty
+        * Empty cells.
+    * side
+        * Index of the symbol to move within `stones`.
+    * bits
+        * Bits of the empty cells (see `getBit`).
+    * count
+        * Number of `bits` (at least 1).
+
+@return
+    * Index of the cell to move in within `bits`.
+*/
+static uint8_t getPlayoutMove(worker_t         *worker,
+                              const bitboard_t  stones[],
+                              const bitboard_t *empty,
+                              uint8_t           side,
+                              const uint16_t    bits[],
+                              uint8_t           count)
+{
+    bitboard_t forced;
+    uint8_t indexes[BOARD_MAX_SIZE * BOARD_MAX_SIZE];
+    uint8_t length, forcedCount, index, i;
+
+    if (worker->tree->playout == MCTS_HEURISTIC)
+    {
+        length = getLength(worker->board);
+        for (i = 0; i < 2; i += 1)
+        {
+            // wins of the symbol to move first then those of the opponent
+            getCompletions(&stones[i == 0 ? side : 1 - side],
+                           empty,
+                           length,
+                           &forced);
+            if (isBitboardEmpty(&forced))
+            {
+                continue;
+            }
+
+            forcedCount = 0;
+            for (index = 0; index < count; index += 1)
+            {
+                if (isBitSet(&forced, bits[index]))
+                {
+                    indexes[forcedCount] = index;
+                    forcedCount += 1;
+                }
+            }
+            return indexes[getRandom(&worker->random) % forcedCount];
+        }
+    }
+
+    return getRandom(&worker->random) % count;
+}
+
+
+/*
+@context
+    * Gets the next random number of `state` (xorshift64*).
+
+@parameters
+    * state
+        * State of the random numbers (never `0`).
+        * Updated to the next state.
+
+@return
+    * Random number.
+*/
+static uint64_t getRandom(uint64_t *state)
+{
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+
+    return *state * 0x2545F4914F6CDD1D;
+}
+
+
+/*
+@context
+    * Gets the score of the move of a child of the root.
+
+@parameters
+    * board
+        * Board of the root.
+        * Unchanged once returned (the move is made and unmade).
+    * symbolSelf
+        * Symbol to move within the root.
+    * node
+        * Child of the root (at least 1 playout finished).
+
+@return
+    * Win if the move wins, otherwise its average playout result from
+      `-SCORE_EVAL_MAX` (every playout lost) to `SCORE_EVAL_MAX`.
+*/
+static score_t getScore(board_t          *board,
+                        char              symbolSelf,
+                        const mctsnode_t *node)
+{
+    bool isWon;
+
+    makeMove(board, node->move, symbolSelf);
+    isWon = isWin(board, symbolSelf);
+    unmakeMove(board);
+
+    if (isWon)
+    {
+        return SCORE_WIN - 1;
+    }
+
+    return (((double)node->points / node->visits) - POINTS_DRAW)
+        * SCORE_EVAL_MAX;
+}
+
+
+/* ------------------------------ END  PRIVATE ------------------------------ */
@@ -0,0 +1,48 @@
+/*
+@context
+    * Provides a second method to find a good move of a Noughts and Crosses
+      state - Monte Carlo tree search (MCTS) instead of minimax.
+    * Scales to large boards minimax cannot finish searching as strength is
+      traded for time - more playouts find a better move.
+        * Each playout selects states of the tree by UCT (visits balanced
+          between the best and the least searched), adds the next states
+          to the tree then plays random moves until the game ends.
+        * Heuristic playouts instead always make a winning move and block
+          the opponent's winning moves when there are any.
+        * Moves of large boards are only cells near a filled cell (as
+          `ORDER_NEAR`) and a win or block ends the choice (as
+          `ORDER_FORCED`).
+    * States of the tree are allocated from an arena of fixed memory - once
+      full states are no longer added but playouts continue.
+    * Threads can share the same tree (tree parallelism) - playouts are
+      made outside its lock and each state being searched counts as a loss
+      until its playout ends, so threads spread across the tree.
+    * Searches of 1 thread are always the same (fixed random seed).
+*/
+
+
+#ifndef _MCTS_H
+    #define _MCTS_H
+
+    #include <stddef.h>
+    #include <stdint.h>
+
+    #include "board.h"
+    #include "minimax.h"
+    #include "score.h"
+
+
+    // moves made by each playout after leaving the tree
+    static const uint8_t MCTS_RANDOM = 0;     // random moves
+    static const uint8_t MCTS_HEURISTIC = 1;  // wins and blocks, else random
+
+
+    uint8_t getBestMoveMCTS(board_t        *board,
+                            char            symbolSelf,
+                            const limits_t *limits,
+                            size_t          memory,
+                            uint8_t         threads,
+                            uint8_t         playout,
+                            score_t        *score);
+
+#endif
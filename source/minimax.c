@@ -1,31 +1,254 @@
 #include "minimax.h"
 
 #include <assert.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <threads.h>
 
+#include "book.h"
+#include "minimax3.h"
+#include "ordering.h"
+#include "stats.h"
+#include "symmetry.h"
+#include "timer.h"
+#include "transposition.h"
 
-// base scores of each end state
-static const int SCORE_WIN = INT8_MAX;
-static const int SCORE_LOSE = INT8_MIN;
-static const int SCORE_DRAW = 0;
 
+// used when a state has no best move to store
+static const uint8_t MOVE_NONE = UINT8_MAX;
 
-static int8_t minimise(board_t *board,
-                       char     symbolSelf,
-                       char     symbolOther,
-                       uint8_t  depth,
-                       int8_t   alpha,
-                       int8_t   beta);
-static int8_t maximise(board_t *board,
-                       char     symbolSelf,
-                       char     symbolOther,
-                       uint8_t  depth,
-                       int8_t   alpha,
-                       int8_t   beta);
+// combined with the board hash so each state is keyed by who moves next
+// (scores are always for the symbol to move)
+static const uint64_t KEY_CROSS = 0x9E6C63D0676A9A99;
 
-static int8_t min(int8_t a,
-                  int8_t b);
-static int8_t max(int8_t a,
-                  int8_t b);
+// states searched between checking if a limit has passed
+static const uint64_t NODES_PER_CHECK = 1024;
+
+
+// limits of a search shared by every thread searching it
+typedef struct
+{
+    // set once any thread passes a limit (or the search is finished)
+    atomic_bool isStopped;
+
+    // states searched and the limits which stop the search once passed
+    atomic_uint_fast64_t nodes;
+    uint64_t maxNodes;
+    uint64_t deadline;
+} shared_t;
+
+// state of a single search shared by every state searched within it
+typedef struct
+{
+    char symbolSelf;
+    char symbolOther;
+
+    // states at this depth are scored heuristically instead of being searched
+    uint8_t maxDepth;
+    bool isDepthReached;
+
+    // states searched since last counted within `shared`
+    uint64_t nodes;
+    bool isStopped;
+    shared_t *shared;
+
+    // table and statistics of the search (and heuristics of `ordering`)
+    engine_t *engine;
+    ordering_t ordering;
+
+#ifdef SEARCH_STATS
+    // time is when the search started until reported
+    stats_t stats;
+#endif
+} search_t;
+
+// root moves split between the threads of a search
+typedef struct
+{
+    uint8_t moves[BOARD_MAX_SIZE * BOARD_MAX_SIZE];
+    uint8_t count;
+
+    // index of the next move to search
+    atomic_uint next;
+
+    // best move and score found so far
+    mtx_t lock;
+    uint8_t bestMove;
+    score_t alpha;
+} split_t;
+
+// thread of a parallel search - each searches its own copy of the board
+// (within the worker so copies are not allocated)
+typedef struct
+{
+    thrd_t thread;
+    bool isStarted;
+    boardstorage_t storage;
+    board_t *board;
+    search_t search;
+
+    // root moves of a root split search
+    split_t *split;
+
+    // depths of a lazy search and the best move and score found
+    uint8_t firstDepth;
+    uint8_t maxDepth;
+    uint8_t move;
+    score_t score;
+} worker_t;
+
+
+// tables, configuration and statistics of every search of an engine
+struct engine_s
+{
+    // `NULL` without a transposition table
+    table_t *table;
+
+    engineconfig_t config;
+
+    // statistics every search adds to - `NULL` when not set
+    stats_t *stats;
+
+    // background search of the opponent's turn (`isPondering` until stopped)
+    worker_t ponderer;
+    shared_t ponderShared;
+    bool isPondering;
+};
+
+
+// engine of the functions without an engine - its table is `NULL` until
+// initialised by `initMinimax`
+static engine_t defaultEngine =
+{
+    .table = NULL,
+    .config = {.threads = 1, .mode = PARALLEL_SPLIT, .heuristics = ORDER_ALL},
+    .stats = NULL,
+    .isPondering = false
+};
+
+
+static engine_t *createEngine(const engineconfig_t *config);
+static void freeEngineTable(engine_t *engine);
+static uint8_t searchExact(engine_t *engine,
+                           board_t  *board,
+                           char      symbolSelf,
+                           score_t  *score);
+static uint8_t searchLimited(engine_t       *engine,
+                             board_t        *board,
+                             char            symbolSelf,
+                             const limits_t *limits,
+                             score_t        *score);
+static uint8_t searchParallel(engine_t       *engine,
+                              board_t        *board,
+                              char            symbolSelf,
+                              const limits_t *limits,
+                              uint8_t         threads,
+                              uint8_t         mode,
+                              score_t        *score);
+
+static void initShared(shared_t       *shared,
+                       const limits_t *limits);
+static void initSearch(search_t *search,
+                       engine_t *engine,
+                       board_t  *board,
+                       char      symbolSelf,
+                       shared_t *shared);
+static uint8_t getFirstMove(board_t *board,
+                            char     symbolSelf);
+static uint8_t getMaxDepth(board_t        *board,
+                           const limits_t *limits);
+
+static uint8_t searchDeepening(board_t  *board,
+                               search_t *search,
+                               uint8_t   firstDepth,
+                               uint8_t   maxDepth,
+                               uint8_t   bestMove,
+                               score_t  *score);
+static uint8_t searchRoot(board_t  *board,
+                          search_t *search,
+                          uint8_t   firstMove,
+                          score_t  *score);
+static uint8_t getRootMoves(board_t  *board,
+                            search_t *search,
+                            uint8_t   firstMove,
+                            uint8_t   moves[]);
+
+static uint8_t searchSplit(worker_t *workers,
+                           uint8_t   threads,
+                           uint8_t   maxDepth,
+                           uint8_t   bestMove,
+                           score_t  *score);
+static int runSplit(void *worker);
+static bool searchSplitMove(worker_t *worker,
+                            uint8_t   index);
+static uint8_t searchLazy(worker_t *workers,
+                          uint8_t   threads,
+                          uint8_t   maxDepth,
+                          uint8_t   bestMove,
+                          score_t  *score);
+static int runLazy(void *worker);
+
+static void mergeStats(search_t *search,
+                       search_t *other);
+static void reportStats(search_t *search);
+
+static score_t searchMove(board_t  *board,
+                          search_t *search,
+                          char      symbol,
+                          uint8_t   depth,
+                          score_t   alpha,
+                          score_t   beta,
+                          bool      isFirst);
+static score_t negamax(board_t  *board,
+                       search_t *search,
+                       char      symbol,
+                       uint8_t   depth,
+                       score_t   alpha,
+                       score_t   beta);
+
+static bool isStopped(search_t *search);
+static score_t getHeuristicScore(board_t *board,
+                                 char     symbol);
+static bool getStoredMove(engine_t *engine,
+                          board_t  *board,
+                          char      symbol,
+                          uint8_t  *move);
+
+static bool isEquivalentMove(board_t       *board,
+                             uint8_t        cell,
+                             const uint8_t  symmetries[],
+                             uint8_t        count);
+
+static bool probeState(board_t  *board,
+                       search_t *search,
+                       uint64_t  key,
+                       uint8_t   symmetry,
+                       uint8_t   depth,
+                       score_t  *alpha,
+                       score_t  *beta,
+                       uint8_t  *move);
+static void storeState(board_t  *board,
+                       search_t *search,
+                       uint64_t  key,
+                       uint8_t   symmetry,
+                       uint8_t   depth,
+                       score_t   alpha,
+                       score_t   beta,
+                       score_t   score,
+                       uint8_t   move);
+
+static uint8_t getRemainingDepth(board_t  *board,
+                                 search_t *search,
+                                 uint8_t   depth);
+static uint64_t getKey(board_t *board,
+                       char     symbol,
+                       uint8_t *symmetry);
+
+static score_t min(score_t a,
+                   score_t b);
+static score_t max(score_t a,
+                   score_t b);
 
 
 /* ------------------------------ START PUBLIC ------------------------------ */
@@ -33,215 +256,2205 @@ static int8_t max(int8_t a,
 
 /*
 @context
-    * Finds the optimal move to make with `symbolSelf` in current `board` state.
-    * Uses minimax with alpha-beta pruning.
-        * Assuming `board` is 3x3, using this method for an entire game will
-          only result in a win or draw for the AI (cannot lose).
-        * Depth is used to encouraged to win using the least amount of moves.
+    * Fills `config` with the configuration of an engine unless changed.
+        * `ENGINE_TABLE_SIZE` entries of the transposition table.
+        * Every game searched to its end by 1 thread.
+        * Every heuristic used to order moves.
+
+@parameters
+    * config
+        * Configuration to fill.
+*/
+void initEngineConfig(engineconfig_t *config)
+{
+    config->tableSize = ENGINE_TABLE_SIZE;
+    config->limits.nodes = 0;
+    config->limits.time = 0;
+    config->limits.depth = 0;
+    config->threads = 1;
+    config->mode = PARALLEL_SPLIT;
+    config->heuristics = ORDER_ALL;
+}
+
+
+/*
+@context
+    * Creates an engine with its own transposition table - searches of
+      different engines share nothing so can run at once without locking.
+    * Freed by `freeEngine`.
+
+@parameters
+    * config
+        * How the engine searches (copied).
+        * `NULL` for the defaults of `initEngineConfig`.
+
+@return
+    * New engine.
+*/
+engine_t *initEngine(const engineconfig_t *config)
+{
+    engine_t *engine;
+
+    engine = createEngine(config);
+    if (engine->config.tableSize > 0)
+    {
+        engine->table = initTable(engine->config.tableSize);
+    }
+
+    return engine;
+}
+
+
+/*
+@context
+    * Creates an engine with the transposition table saved to the file at
+      `path` (by `saveEngine` or `saveMinimax` of any process) instead of an
+      empty table (same as `loadMinimax`).
+
+@parameters
+    * config
+        * How the engine searches (copied) - its table size is ignored.
+        * `NULL` for the defaults of `initEngineConfig`.
+    * path
+        * Path of the file to load.
+
+@return
+    * New engine.
+    * `NULL` if the file could not be loaded.
+*/
+engine_t *loadEngine(const engineconfig_t *config,
+                     const char           *path)
+{
+    engine_t *engine;
+
+    engine = createEngine(config);
+    engine->table = loadTable(path);
+    if (engine->table == NULL)
+    {
+        free(engine);
+        return NULL;
+    }
+
+    return engine;
+}
+
+
+/*
+@context
+    * Saves the transposition table of `engine` to the file at `path` (same
+      as `saveMinimax`).
+
+@parameters
+    * engine
+        * Engine to save the table of.
+    * path
+        * Path of the file to write.
+
+@return
+    * Indicates if the whole table was written.
+    * Nothing is written without the table.
+*/
+bool saveEngine(engine_t   *engine,
+                const char *path)
+{
+    stopEnginePondering(engine);
+
+    return engine->table != NULL && saveTable(engine->table, path);
+}
+
+
+/*
+@context
+    * Frees `engine` and its transposition table (stopping any pondering).
+
+@parameters
+    * engine
+        * Engine to free.
+*/
+void freeEngine(engine_t *engine)
+{
+    freeEngineTable(engine);
+    free(engine);
+}
+
+
+/*
+@context
+    * Sets the statistics every search of `engine` adds to (same as
+      `setStats`).
+    * Engines searching at once may share the same statistics (added to
+      under a lock once each search finishes).
+
+@parameters
+    * engine
+        * Engine to add the statistics of.
+    * stats
+        * Statistics to add to.
+        * `NULL` stops adding statistics.
+*/
+void setEngineStats(engine_t *engine,
+                    stats_t  *stats)
+{
+    engine->stats = stats;
+}
+
+
+/*
+@context
+    * Finds the best move to make with `symbolSelf` as `engine` is configured.
+        * Without limits and threads - the optimal move (`getBestMoveScore`).
+        * Otherwise within its limits by its threads (`getBestMoveParallel`).
+
+@parameters
+    * engine
+        * Engine to search with.
+    * board
+        * Current state of the Noughts and Crosses game.
+    * symbolSelf
+        * Symbol to find best move for.
+    * score
+        * Set to the score of the best move.
+
+@return
+    * Cell of the best move.
+*/
+uint8_t getEngineMove(engine_t *engine,
+                      board_t  *board,
+                      char      symbolSelf,
+                      score_t  *score)
+{
+    const engineconfig_t *config;
+
+    config = &engine->config;
+    if (config->limits.nodes == 0 && config->limits.time == 0
+        && config->limits.depth == 0 && config->threads <= 1)
+    {
+        return searchExact(engine, board, symbolSelf, score);
+    }
+
+    return searchParallel(engine,
+                          board,
+                          symbolSelf,
+                          &config->limits,
+                          config->threads,
+                          config->mode,
+                          score);
+}
+
+
+/*
+@context
+    * Gets the principal variation from `board` of the last searches of
+      `engine` (same as `getPrincipalVariation`).
+
+@parameters
+    * engine
+        * Engine which searched `board`.
+    * board
+        * Current state of the Noughts and Crosses game.
+        * Unchanged once returned (moves are made and unmade).
+    * symbolSelf
+        * Symbol to move first.
+    * moves
+        * Filled with the cell of each move in the order they are made.
+    * maxMoves
+        * Most `moves` to get.
+
+@return
+    * Number of `moves`.
+*/
+uint8_t getEnginePrincipalVariation(engine_t *engine,
+                                    board_t  *board,
+                                    char      symbolSelf,
+                                    uint8_t   moves[],
+                                    uint8_t   maxMoves)
+{
+    uint8_t count, i;
+    char symbol;
+
+    symbol = symbolSelf;
+    count = 0;
+    while (count < maxMoves && !isWin(board, NOUGHT) && !isWin(board, CROSS)
+           && !isFull(board)
+           && getStoredMove(engine, board, symbol, &moves[count]))
+    {
+        makeMove(board, moves[count], symbol);
+        symbol = symbol == NOUGHT ? CROSS : NOUGHT;
+        count += 1;
+    }
+
+    for (i = 0; i < count; i += 1)
+    {
+        unmakeMove(board);
+    }
+
+    return count;
+}
+
+
+/*
+@context
+    * Starts searching `board` in the background with `engine` (same as
+      `startPondering`) - stopped by `stopEnginePondering`.
+    * Each engine ponders on its own so engines can ponder at once.
+
+@parameters
+    * engine
+        * Engine to fill the transposition table of.
+    * board
+        * Current state of the Noughts and Crosses game.
+        * Copied so can be changed while pondering.
+    * symbolOther
+        * Symbol of the opponent - to move next.
+*/
+void startEnginePondering(engine_t *engine,
+                          board_t  *board,
+                          char      symbolOther)
+{
+    worker_t *ponderer;
+    uint8_t move;
+    score_t score;
+
+    stopEnginePondering(engine);
+
+    if (engine->table == NULL || isWin(board, NOUGHT) || isWin(board, CROSS)
+        || isFull(board) || isBoard3(board)
+        || lookupBook(board, symbolOther, &move, &score))
+    {
+        return;
+    }
+
+    ponderer = &engine->ponderer;
+    ponderer->board = copyBoard(board, &ponderer->storage);
+    initShared(&engine->ponderShared, NULL);
+    initSearch(&ponderer->search,
+               engine,
+               ponderer->board,
+               symbolOther,
+               &engine->ponderShared);
+
+    ponderer->firstDepth = 1;
+    ponderer->maxDepth = getEmptyCount(board);
+    ponderer->move = getFirstMove(board, symbolOther);
+
+    engine->isPondering = thrd_create(&ponderer->thread,
+                                      runLazy,
+                                      ponderer) == thrd_success;
+}
+
+
+/*
+@context
+    * Stops the background search of `engine` (same as `stopPondering`).
+
+@parameters
+    * engine
+        * Engine to stop pondering.
+*/
+void stopEnginePondering(engine_t *engine)
+{
+    if (engine->isPondering)
+    {
+        atomic_store(&engine->ponderShared.isStopped, true);
+        thrd_join(engine->ponderer.thread, NULL);
+        engine->isPondering = false;
+    }
+}
+
+
+/*
+@context
+    * Initialises the transposition table of the default engine.
+    * Every state searched is stored so it is never searched twice.
+    * Searches without the table if never initialised.
+
+@parameters
+    * tableSize
+        * Number of entries within the transposition table.
+        * Rounded down to a power of 2.
+        * `0` disables the transposition table.
+*/
+void initMinimax(uint32_t tableSize)
+{
+    freeEngineTable(&defaultEngine);
+
+    if (tableSize > 0)
+    {
+        defaultEngine.table = initTable(tableSize);
+    }
+}
+
+
+/*
+@context
+    * Replaces the transposition table of the default engine with the table
+      saved to the file at `path` (by `saveMinimax` of any process).
+    * States solved by earlier processes are found instead of searched again.
+    * The file is mapped so no time is spent reading it and processes
+      loading the same file share its memory until they store entries.
+
+@parameters
+    * path
+        * Path of the file to load.
+
+@return
+    * Indicates if the file was loaded.
+    * Searches without the table if not (until `initMinimax`).
+*/
+bool loadMinimax(const char *path)
+{
+    freeEngineTable(&defaultEngine);
+
+    defaultEngine.table = loadTable(path);
+
+    return defaultEngine.table != NULL;
+}
+
+
+/*
+@context
+    * Saves the transposition table of the default engine to the file at
+      `path` so later processes can load it (`loadMinimax`).
+    * Stops pondering first so no entry changes while it is written.
+
+@parameters
+    * path
+        * Path of the file to write.
+
+@return
+    * Indicates if the whole table was written.
+    * Nothing is written without the table.
+*/
+bool saveMinimax(const char *path)
+{
+    return saveEngine(&defaultEngine, path);
+}
+
+
+/*
+@context
+    * Frees the transposition table of the default engine.
+*/
+void freeMinimax()
+{
+    freeEngineTable(&defaultEngine);
+}
+
+
+/*
+@context
+    * Sets the heuristics used to order the moves of every search of the
+      default engine.
+    * Ordering changes how quickly moves are found (and which of the equally
+      best moves is found), never how good they are.
+
+@parameters
+    * orderHeuristics
+        * Heuristics to use (`ORDER_` flags combined).
+        * Every heuristic is used if never set.
+*/
+void setOrdering(uint8_t orderHeuristics)
+{
+    defaultEngine.config.heuristics = orderHeuristics;
+}
+
+
+/*
+@context
+    * Sets the statistics every search of the default engine adds to once
+      finished.
+    * Only added to when compiled with `SEARCH_STATS` defined.
+    * Searches answered by the opening book are not added.
+
+@parameters
+    * stats
+        * Statistics to add to (cleared by the caller).
+        * `NULL` stops adding statistics.
+*/
+void setStats(stats_t *stats)
+{
+    setEngineStats(&defaultEngine, stats);
+}
+
+
+/*
+@context
+    * Finds the optimal move to make with `symbolSelf` in current `board` state.
+    * Uses minimax with alpha-beta pruning.
+        * Assuming `board` is 3x3, using this method for an entire game will
+          only result in a win or draw for the AI (cannot lose).
+        * Depth is used to encouraged to win using the least amount of moves.
+
+@parameters
+    * board
+        * Current state of the Noughts and Crosses game.
+    * symbolSelf
+        * Symbol to find best move for.
+
+@return
+    * Cell of the optimal move.
+*/
+uint8_t getBestMove(board_t *board,
+                    char     symbolSelf)
+{
+    score_t score;
+
+    return getBestMoveScore(board, symbolSelf, &score);
+}
+
+
+/*
+@context
+    * Finds the optimal move to make with `symbolSelf` in current `board` state
+      and the score of making it.
+    * Looked up from the opening book if `board` is within it, otherwise uses
+      minimax with alpha-beta pruning (same as `getBestMove`).
+
+@parameters
+    * board
+        * Current state of the Noughts and Crosses game.
+    * symbolSelf
+        * Symbol to find best move for.
+    * score
+        * Set to the score of the optimal move.
+        * Positive for a win, `0` for a draw and negative for a loss.
+        * Wins and losses in less moves are further from `0`.
+
+@return
+    * Cell of the optimal move.
+*/
+uint8_t getBestMoveScore(board_t *board,
+                         char     symbolSelf,
+                         score_t *score)
+{
+    return searchExact(&defaultEngine, board, symbolSelf, score);
+}
+
+
+/*
+@context
+    * Finds the best move to make with `symbolSelf` within `limits`.
+    * Uses iterative deepening - searches 1 move deep, then 2 moves deep and so
+      on until a limit is passed or every game is searched to its end.
+        * The best move of each completed depth is searched first by the next.
+        * Moves of a depth stopped by a limit are ignored.
+    * States at the depth being searched are scored by a heuristic evaluation
+      of their threats so the best move is only optimal if every game was
+      searched to its end.
+
+@parameters
+    * board
+        * Current state of the Noughts and Crosses game.
+    * symbolSelf
+        * Symbol to find best move for.
+    * limits
+        * Most states, time and depth to search.
+    * score
+        * Set to the score of the best move at the deepest completed depth.
+
+@return
+    * Cell of the best move at the deepest completed depth.
+    * First valid move if no depth completed.
+*/
+uint8_t getBestMoveLimited(board_t        *board,
+                           char            symbolSelf,
+                           const limits_t *limits,
+                           score_t        *score)
+{
+    return searchLimited(&defaultEngine, board, symbolSelf, limits, score);
+}
+
+
+/*
+@context
+    * Finds the best move to make with `symbolSelf` within `limits` using
+      `threads` threads (same as `getBestMoveLimited` otherwise).
+    * Each thread searches its own copy of `board`.
+    * Threads search in 1 of 2 modes.
+        * `PARALLEL_SPLIT` - each depth the first move is searched then the
+          other moves are split between the threads.
+        * `PARALLEL_LAZY` - every thread searches every move (half a depth
+          ahead) sharing what they find through the transposition table so
+          each searches different moves first - requires `initMinimax`.
+    * Which of the equally best moves is found can vary between searches.
+
+@parameters
+    * board
+        * Current state of the Noughts and Crosses game.
+    * symbolSelf
+        * Symbol to find best move for.
+    * limits
+        * Most states (of every thread), time and depth to search.
+    * threads
+        * Number of threads to search with.
+        * `0` and `1` search without starting a thread.
+    * mode
+        * How threads share the search (`PARALLEL_SPLIT` or `PARALLEL_LAZY`).
+    * score
+        * Set to the score of the best move at the deepest completed depth.
+
+@return
+    * Cell of the best move at the deepest completed depth.
+    * First valid move if no depth completed.
+*/
+uint8_t getBestMoveParallel(board_t        *board,
+                            char            symbolSelf,
+                            const limits_t *limits,
+                            uint8_t         threads,
+                            uint8_t         mode,
+                            score_t        *score)
+{
+    return searchParallel(&defaultEngine,
+                          board,
+                          symbolSelf,
+                          limits,
+                          threads,
+                          mode,
+                          score);
+}
+
+
+/*
+@context
+    * Gets the principal variation from `board` - the moves both symbols are
+      expected to make in turn according to the last searches.
+    * Each move is the stored best move of the state it is made in (from the
+      opening book, the 3x3 search or the transposition table) so is only as
+      long as the states stored since searching `board`.
+
+@parameters
+    * board
+        * Current state of the Noughts and Crosses game.
+        * Unchanged once returned (moves are made and unmade).
+    * symbolSelf
+        * Symbol to move first.
+    * moves
+        * Filled with the cell of each move in the order they are made.
+    * maxMoves
+        * Most `moves` to get.
+
+@return
+    * Number of `moves`.
+*/
+uint8_t getPrincipalVariation(board_t *board,
+                              char     symbolSelf,
+                              uint8_t  moves[],
+                              uint8_t  maxMoves)
+{
+    return getEnginePrincipalVariation(&defaultEngine,
+                                       board,
+                                       symbolSelf,
+                                       moves,
+                                       maxMoves);
+}
+
+
+/*
+@context
+    * Starts searching `board` in the background while the opponent decides
+      their move (pondering) - stopped by `stopPondering`.
+    * Fills the transposition table with every reply to the opponent's move
+      so the next search (once the opponent has moved) is mostly answered by
+      the table instead of searched.
+        * Searched deeper and deeper (as `getBestMoveLimited`) so the replies
+          to every move are stored before any are searched deeper.
+        * Stops by itself once every game is searched to its end.
+    * Does nothing without the transposition table or if `board` is solved
+      without searching (by the opening book or the 3x3 search).
+    * Any pondering already started is stopped first.
+
+@parameters
+    * board
+        * Current state of the Noughts and Crosses game.
+        * Copied so can be changed while pondering.
+    * symbolOther
+        * Symbol of the opponent - to move next.
+*/
+void startPondering(board_t *board,
+                    char     symbolOther)
+{
+    startEnginePondering(&defaultEngine, board, symbolOther);
+}
+
+
+/*
+@context
+    * Stops searching in the background (started by `startPondering`) and
+      waits for its thread to finish.
+    * What was stored in the transposition table is kept for later searches.
+    * Does nothing if not pondering.
+*/
+void stopPondering()
+{
+    stopEnginePondering(&defaultEngine);
+}
+
+
+/* ------------------------------- END PUBLIC ------------------------------- */
+/* ----------------------------- START  PRIVATE ----------------------------- */
+
+
+/*
+@context
+    * Allocates an engine without a transposition table.
+
+@parameters
+    * config
+        * How the engine searches (copied).
+        * `NULL` for the defaults of `initEngineConfig`.
+
+@return
+    * New engine.
+*/
+static engine_t *createEngine(const engineconfig_t *config)
+{
+    engine_t *engine;
+
+    engine = malloc(sizeof(engine_t));
+    assert(engine != NULL);
+
+    if (config != NULL)
+    {
+        engine->config = *config;
+    }
+    else
+    {
+        initEngineConfig(&engine->config);
+    }
+
+    engine->table = NULL;
+    engine->stats = NULL;
+    engine->isPondering = false;
+
+    return engine;
+}
+
+
+/*
+@context
+    * Frees the transposition table of `engine` (stopping any pondering as
+      it stores into the table until stopped).
+
+@parameters
+    * engine
+        * Engine to free the table of.
+*/
+static void freeEngineTable(engine_t *engine)
+{
+    stopEnginePondering(engine);
+
+    if (engine->table != NULL)
+    {
+        freeTable(engine->table);
+        engine->table = NULL;
+    }
+}
+
+
+/*
+@context
+    * Finds the optimal move with the table, ordering and statistics of
+      `engine` (see `getBestMoveScore`).
+
+@parameters
+    * engine
+        * Engine to search with.
+    * board
+        * Current state of the Noughts and Crosses game.
+    * symbolSelf
+        * Symbol to find best move for.
+    * score
+        * Set to the score of the optimal move.
+
+@return
+    * Cell of the optimal move.
+*/
+static uint8_t searchExact(engine_t *engine,
+                           board_t  *board,
+                           char      symbolSelf,
+                           score_t  *score)
+{
+    shared_t shared;
+    search_t search;
+    uint8_t bestMove;
+
+    // solved states do not need to be searched
+    if (lookupBook(board, symbolSelf, &bestMove, score))
+    {
+        return bestMove;
+    }
+
+    // standard 3x3 game has its own specialised search
+    if (isBoard3(board))
+    {
+        return getBestMove3(board, symbolSelf, engine->stats, score);
+    }
+
+    initShared(&shared, NULL);
+    initSearch(&search, engine, board, symbolSelf, &shared);
+    bestMove = searchRoot(board, &search, MOVE_NONE, score);
+
+    // no best move found - `board` was full - no move possible
+    assert(bestMove != MOVE_NONE);
+
+    STATS_DEPTH(&search.stats, getEmptyCount(board));
+    reportStats(&search);
+
+    return bestMove;
+}
+
+
+/*
+@context
+    * Finds the best move within `limits` with the table, ordering and
+      statistics of `engine` (see `getBestMoveLimited`).
+
+@parameters
+    * engine
+        * Engine to search with.
+    * board
+        * Current state of the Noughts and Crosses game.
+    * symbolSelf
+        * Symbol to find best move for.
+    * limits
+        * Most states, time and depth to search.
+    * score
+        * Set to the score of the best move at the deepest completed depth.
+
+@return
+    * Cell of the best move at the deepest completed depth.
+*/
+static uint8_t searchLimited(engine_t       *engine,
+                             board_t        *board,
+                             char            symbolSelf,
+                             const limits_t *limits,
+                             score_t        *score)
+{
+    shared_t shared;
+    search_t search;
+    uint8_t bestMove;
+
+    if (lookupBook(board, symbolSelf, &bestMove, score))
+    {
+        return bestMove;
+    }
+
+    initShared(&shared, limits);
+    initSearch(&search, engine, board, symbolSelf, &shared);
+
+    *score = SCORE_DRAW;
+    bestMove = searchDeepening(board,
+                               &search,
+                               1,
+                               getMaxDepth(board, limits),
+                               getFirstMove(board, symbolSelf),
+                               score);
+
+    reportStats(&search);
+
+    return bestMove;
+}
+
+
+/*
+@context
+    * Finds the best move within `limits` using `threads` threads with the
+      table, ordering and statistics of `engine` (see
+      `getBestMoveParallel`).
+
+@parameters
+    * engine
+        * Engine to search with.
+    * board
+        * Current state of the Noughts and Crosses game.
+    * symbolSelf
+        * Symbol to find best move for.
+    * limits
+        * Most states (of every thread), time and depth to search.
+    * threads
+        * Number of threads to search with.
+    * mode
+        * How threads share the search (`PARALLEL_SPLIT` or `PARALLEL_LAZY`).
+    * score
+        * Set to the score of the best move at the deepest completed depth.
+
+@return
+    * Cell of the best move at the deepest completed depth.
+*/
+static uint8_t searchParallel(engine_t       *engine,
+                              board_t        *board,
+                              char            symbolSelf,
+                              const limits_t *limits,
+                              uint8_t         threads,
+                              uint8_t         mode,
+                              score_t        *score)
+{
+    shared_t shared;
+    worker_t *workers;
+    uint8_t bestMove, i;
+
+    if (threads <= 1)
+    {
+        return searchLimited(engine, board, symbolSelf, limits, score);
+    }
+
+    if (lookupBook(board, symbolSelf, &bestMove, score))
+    {
+        return bestMove;
+    }
+    bestMove = getFirstMove(board, symbolSelf);
+    *score = SCORE_DRAW;
+
+    initShared(&shared, limits);
+
+    workers = malloc(sizeof(worker_t) * threads);
+    assert(workers != NULL);
+
+    for (i = 0; i < threads; i += 1)
+    {
+        workers[i].board = copyBoard(board, &workers[i].storage);
+        initSearch(&workers[i].search,
+                   engine,
+                   workers[i].board,
+                   symbolSelf,
+                   &shared);
+    }
+
+    if (mode == PARALLEL_LAZY)
+    {
+        bestMove = searchLazy(workers,
+                              threads,
+                              getMaxDepth(board, limits),
+                              bestMove,
+                              score);
+    }
+    else
+    {
+        bestMove = searchSplit(workers,
+                               threads,
+                               getMaxDepth(board, limits),
+                               bestMove,
+                               score);
+    }
+
+    // every thread is part of the same search (taking the time of the first)
+    for (i = 1; i < threads; i += 1)
+    {
+        mergeStats(&workers[0].search, &workers[i].search);
+    }
+    reportStats(&workers[0].search);
+
+    free(workers);
+
+    return bestMove;
+}
+
+
+/*
+@context
+    * Initialises the limits shared by every thread of a search.
+
+@parameters
+    * shared
+        * Limits to initialise.
+    * limits
+        * Most states and time to search.
+        * `NULL` searches without limits.
+*/
+static void initShared(shared_t       *shared,
+                       const limits_t *limits)
+{
+    atomic_init(&shared->isStopped, false);
+    atomic_init(&shared->nodes, 0);
+    shared->maxNodes = 0;
+    shared->deadline = 0;
+
+    if (limits != NULL)
+    {
+        shared->maxNodes = limits->nodes;
+        if (limits->time > 0)
+        {
+            shared->deadline = getTime() + (limits->time * NS_PER_MS);
+        }
+    }
+}
+
+
+/*
+@context
+    * Initialises the state of a search.
+
+@parameters
+    * search
+        * Search to initialise.
+    * board
+        * State of the Noughts and Crosses game to search.
+    * symbolSelf
+        * Symbol to find best move for.
+    * shared
+        * Limits of the search (shared with any other thread searching).
+*/
+static void initSearch(search_t *search,
+                       engine_t *engine,
+                       board_t  *board,
+                       char      symbolSelf,
+                       shared_t *shared)
+{
+    search->symbolSelf = symbolSelf;
+    search->symbolOther = symbolSelf == NOUGHT ? CROSS : NOUGHT;
+
+    search->maxDepth = UINT8_MAX;
+    search->isDepthReached = false;
+
+    search->nodes = 0;
+    search->isStopped = false;
+    search->shared = shared;
+
+    search->engine = engine;
+    initOrdering(&search->ordering, board, engine->config.heuristics);
+
+#ifdef SEARCH_STATS
+    clearStats(&search->stats);
+    search->stats.time = getTime();
+#endif
+}
+
+
+/*
+@context
+    * Gets the first valid `symbolSelf` move - made if no depth of a limited
+      search completes.
+
+@parameters
+    * board
+        * Current state of the Noughts and Crosses game.
+    * symbolSelf
+        * Symbol to move.
+
+@return
+    * Cell of the first valid move.
+*/
+static uint8_t getFirstMove(board_t *board,
+                            char     symbolSelf)
+{
+    uint8_t move;
+
+    move = 0;
+    while (!isValidMove(board, move, symbolSelf))
+    {
+        move += 1;
+
+        // no valid move - `board` was full - no move possible
+        assert(move < getSize(board) * getSize(board));
+    }
+
+    return move;
+}
+
+
+/*
+@context
+    * Gets the deepest depth to search `board` to within `limits`.
+
+@parameters
+    * board
+        * Current state of the Noughts and Crosses game.
+    * limits
+        * Most depth to search.
+
+@return
+    * Deepest depth to search - never more than the moves left.
+*/
+static uint8_t getMaxDepth(board_t        *board,
+                           const limits_t *limits)
+{
+    if (limits->depth > 0 && limits->depth < getEmptyCount(board))
+    {
+        return limits->depth;
+    }
+    return getEmptyCount(board);
+}
+
+
+/*
+@context
+    * Searches `board` deeper and deeper (iterative deepening) until
+      `maxDepth`, a limit is passed or every game is searched to its end.
+    * The best move of each completed depth is searched first by the next.
+    * Moves of a depth stopped by a limit are ignored.
+
+@parameters
+    * board
+        * Current state of the Noughts and Crosses game.
+    * search
+        * Search to find the best move within.
+    * firstDepth
+        * Depth to search first.
+    * maxDepth
+        * Deepest depth to search.
+    * bestMove
+        * Move to make if no depth completes.
+    * score
+        * Set to the score of the best move at the deepest completed depth.
+        * Unchanged if no depth completes.
+
+@return
+    * Cell of the best move at the deepest completed depth.
+*/
+static uint8_t searchDeepening(board_t  *board,
+                               search_t *search,
+                               uint8_t   firstDepth,
+                               uint8_t   maxDepth,
+                               uint8_t   bestMove,
+                               score_t  *score)
+{
+    uint8_t move, depth;
+    score_t depthScore;
+
+    for (depth = firstDepth; depth <= maxDepth; depth += 1)
+    {
+        search->maxDepth = depth;
+        search->isDepthReached = false;
+
+        // the first valid move is not a searched best move so is not first
+        move = searchRoot(board,
+                          search,
+                          depth > firstDepth ? bestMove : MOVE_NONE,
+                          &depthScore);
+        if (search->isStopped)
+        {
+            break;
+        }
+
+        bestMove = move;
+        *score = depthScore;
+        STATS_DEPTH(&search->stats, depth);
+
+        // deeper searches cannot change a search which reached every end state
+        // or found a win or loss (every shorter game was already searched)
+        if (!search->isDepthReached
+            || depthScore > SCORE_EVAL_MAX || depthScore < -SCORE_EVAL_MAX)
+        {
+            break;
+        }
+    }
+
+    return bestMove;
+}
+
+
+/*
+@context
+    * Scores every valid `symbolSelf` move to find the best move.
+    * Moves equivalent to another move through a symmetry are skipped.
+    * The result is stored in the transposition table so the principal
+      variation starts from `board`.
+
+@parameters
+    * board
+        * Current state of the Noughts and Crosses game.
+    * search
+        * Search to find the best move within.
+    * firstMove
+        * Move to score first - the best move of a previous search.
+        * `MOVE_NONE` if there is no previous search.
+    * score
+        * Set to the score of the best move.
+
+@return
+    * Cell of the best move.
+    * `MOVE_NONE` if no moves or `search` stopped before any move scored.
+*/
+static uint8_t searchRoot(board_t  *board,
+                          search_t *search,
+                          uint8_t   firstMove,
+                          score_t  *score)
+{
+    uint8_t moves[BOARD_MAX_SIZE * BOARD_MAX_SIZE];
+    uint8_t i, move, count, bestMove, symmetry;
+    score_t alpha, moveScore;
+    uint64_t key;
+
+    alpha = SCORE_LOSE;
+    bestMove = MOVE_NONE;
+    STATS_NODE(&search->stats, 0);
+
+    // try and score every valid `symbolSelf` move to find next best move
+    count = getRootMoves(board, search, firstMove, moves);
+    for (i = 0; i < count; i += 1)
+    {
+        move = moves[i];
+
+        // make `symbolSelf` move, `score` it and unmake the move
+        makeMove(board, move, search->symbolSelf);
+        moveScore = searchMove(board,
+                               search,
+                               search->symbolOther,
+                               1,
+                               alpha,
+                               SCORE_WIN,
+                               i == 0);
+        unmakeMove(board);
+
+        if (search->isStopped)
+        {
+            break;
+        }
+
+        // current move is a better move than the previous best move
+        if (moveScore > alpha)
+        {
+            alpha = moveScore;
+            bestMove = move;
+        }
+    }
+
+    if (!search->isStopped && bestMove != MOVE_NONE)
+    {
+        key = getKey(board, search->symbolSelf, &symmetry);
+        storeState(board,
+                   search,
+                   key,
+                   symmetry,
+                   0,
+                   SCORE_LOSE,
+                   SCORE_WIN,
+                   alpha,
+                   bestMove);
+    }
+
+    *score = alpha;
+    return bestMove;
+}
+
+
+/*
+@context
+    * Gets every valid `symbolSelf` move to score at the root of a search in
+      the order to score them.
+    * Moves equivalent to another move through a symmetry are skipped.
+
+@parameters
+    * board
+        * Current state of the Noughts and Crosses game.
+    * search
+        * Search `board` is the root of.
+    * firstMove
+        * Move to score first - the best move of a previous search.
+        * `MOVE_NONE` if there is no previous search.
+    * moves
+        * Filled with the cell of every move to score.
+        * Requires space for every cell of `board`.
+
+@return
+    * Number of moves to score.
+*/
+static uint8_t getRootMoves(board_t  *board,
+                            search_t *search,
+                            uint8_t   firstMove,
+                            uint8_t   moves[])
+{
+    uint8_t ordered[BOARD_MAX_SIZE * BOARD_MAX_SIZE];
+    uint64_t priorities[BOARD_MAX_SIZE * BOARD_MAX_SIZE];
+    uint8_t symmetries[SYMMETRY_COUNT];
+    uint8_t i, move, count, orderedCount, symmetriesCount, symmetry;
+
+    // symmetries which leave `board` unchanged make some moves equivalent
+    symmetriesCount = 0;
+    for (symmetry = 1; symmetry < SYMMETRY_COUNT; symmetry += 1)
+    {
+        if (isSymmetric(board, symmetry))
+        {
+            symmetries[symmetriesCount] = symmetry;
+            symmetriesCount += 1;
+        }
+    }
+
+    orderedCount = getOrderedMoves(&search->ordering,
+                                   board,
+                                   search->symbolSelf,
+                                   firstMove,
+                                   0,
+                                   ordered,
+                                   priorities);
+
+    count = 0;
+    for (i = 0; i < orderedCount; i += 1)
+    {
+        move = selectMove(ordered, priorities, orderedCount, i);
+        if (!isEquivalentMove(board, move, symmetries, symmetriesCount))
+        {
+            moves[count] = move;
+            count += 1;
+        }
+    }
+
+    return count;
+}
+
+
+/*
+@context
+    * Searches deeper and deeper (same as `searchDeepening`) splitting the
+      moves of each depth between `threads` threads.
+    * The first (likely best) move is searched alone so the other threads
+      prune using its score.
+
+@parameters
+    * workers
+        * Threads to search with - each with its own copy of the board.
+    * threads
+        * Number of `workers`.
+    * maxDepth
+        * Deepest depth to search.
+    * bestMove
+        * Move to make if no depth completes.
+    * score
+        * Set to the score of the best move at the deepest completed depth.
+
+@return
+    * Cell of the best move at the deepest completed depth.
+*/
+static uint8_t searchSplit(worker_t *workers,
+                           uint8_t   threads,
+                           uint8_t   maxDepth,
+                           uint8_t   bestMove,
+                           score_t  *score)
+{
+    split_t split;
+    uint8_t i, depth;
+    bool isDepthReached;
+
+    mtx_init(&split.lock, mtx_plain);
+
+    for (depth = 1; depth <= maxDepth; depth += 1)
+    {
+        for (i = 0; i < threads; i += 1)
+        {
+            workers[i].search.maxDepth = depth;
+            workers[i].search.isDepthReached = false;
+            workers[i].split = &split;
+        }
+
+        split.count = getRootMoves(workers[0].board,
+                                   &workers[0].search,
+                                   depth > 1 ? bestMove : MOVE_NONE,
+                                   split.moves);
+        atomic_init(&split.next, 1);
+        split.bestMove = MOVE_NONE;
+        split.alpha = SCORE_LOSE;
+
+        // other threads wait for the first move to be scored
+        if (!searchSplitMove(&workers[0], 0))
+        {
+            break;
+        }
+
+        // moves of a thread which fails to start are searched by the others
+        for (i = 1; i < threads; i += 1)
+        {
+            workers[i].isStarted = thrd_create(&workers[i].thread,
+                                               runSplit,
+                                               &workers[i]) == thrd_success;
+        }
+        runSplit(&workers[0]);
+
+        isDepthReached = workers[0].search.isDepthReached;
+        for (i = 1; i < threads; i += 1)
+        {
+            if (workers[i].isStarted)
+            {
+                thrd_join(workers[i].thread, NULL);
+                isDepthReached |= workers[i].search.isDepthReached;
+            }
+        }
+
+        if (atomic_load(&workers[0].search.shared->isStopped))
+        {
+            break;
+        }
+
+        bestMove = split.bestMove;
+        *score = split.alpha;
+        STATS_DEPTH(&workers[0].search.stats, depth);
+
+        // deeper searches cannot change a search which reached every end state
+        // or found a win or loss (every shorter game was already searched)
+        if (!isDepthReached
+            || split.alpha > SCORE_EVAL_MAX || split.alpha < -SCORE_EVAL_MAX)
+        {
+            break;
+        }
+    }
+
+    mtx_destroy(&split.lock);
+
+    return bestMove;
+}
+
+
+/*
+@context
+    * Searches root moves of a root split search until none are left.
+    * Run by every thread of the search.
+
+@parameters
+    * worker
+        * Thread searching the moves.
+
+@return
+    * Always `0` (required by `thrd_create`).
+*/
+static int runSplit(void *worker)
+{
+    worker_t *self;
+    unsigned index;
+
+    self = worker;
+    while ((index = atomic_fetch_add(&self->split->next, 1))
+           < self->split->count)
+    {
+        if (!searchSplitMove(self, index))
+        {
+            break;
+        }
+    }
+
+    return 0;
+}
+
+
+/*
+@context
+    * Scores the root move at `index` of a root split search.
+    * Searched using the best score any thread has found so far so moves which
+      cannot be better are pruned.
+
+@parameters
+    * worker
+        * Thread searching the move.
+    * index
+        * Index of the move within the root moves.
+
+@return
+    * Indicates if the move was scored (otherwise the search stopped).
+*/
+static bool searchSplitMove(worker_t *worker,
+                            uint8_t   index)
+{
+    search_t *search;
+    split_t *split;
+    uint8_t move;
+    score_t alpha, moveScore;
+
+    search = &worker->search;
+    split = worker->split;
+    move = split->moves[index];
+
+    mtx_lock(&split->lock);
+    alpha = split->alpha;
+    mtx_unlock(&split->lock);
+
+    // make `symbolSelf` move, `score` it and unmake the move
+    makeMove(worker->board, move, search->symbolSelf);
+    moveScore = searchMove(worker->board,
+                           search,
+                           search->symbolOther,
+                           1,
+                           alpha,
+                           SCORE_WIN,
+                           index == 0);
+    unmakeMove(worker->board);
+
+    if (search->isStopped)
+    {
+        return false;
+    }
+
+    // another thread may have found a better move while this was searched
+    mtx_lock(&split->lock);
+    if (moveScore > split->alpha || split->bestMove == MOVE_NONE)
+    {
+        split->alpha = moveScore;
+        split->bestMove = move;
+    }
+    mtx_unlock(&split->lock);
+
+    return true;
+}
+
+
+/*
+@context
+    * Searches deeper and deeper (same as `searchDeepening`) with `threads`
+      threads searching every move at once (Lazy SMP).
+    * Threads share what they find through the transposition table so going
+      through it differently (half the threads a depth ahead) makes each
+      search different moves first.
+    * Only the moves found by the first thread are used - the others stop
+      once it finishes.
+
+@parameters
+    * workers
+        * Threads to search with - each with its own copy of the board.
+    * threads
+        * Number of `workers`.
+    * maxDepth
+        * Deepest depth to search.
+    * bestMove
+        * Move to make if no depth completes.
+    * score
+        * Set to the score of the best move at the deepest completed depth.
+
+@return
+    * Cell of the best move at the deepest completed depth.
+*/
+static uint8_t searchLazy(worker_t *workers,
+                          uint8_t   threads,
+                          uint8_t   maxDepth,
+                          uint8_t   bestMove,
+                          score_t  *score)
+{
+    uint8_t i;
+
+    for (i = 0; i < threads; i += 1)
+    {
+        workers[i].firstDepth = 1 + (i % 2);
+        workers[i].maxDepth = maxDepth;
+        workers[i].move = bestMove;
+        workers[i].score = *score;
+
+        if (workers[i].firstDepth > maxDepth)
+        {
+            workers[i].firstDepth = maxDepth;
+        }
+    }
+
+    // a thread which fails to start only leaves fewer threads searching
+    for (i = 1; i < threads; i += 1)
+    {
+        workers[i].isStarted = thrd_create(&workers[i].thread,
+                                           runLazy,
+                                           &workers[i]) == thrd_success;
+    }
+    runLazy(&workers[0]);
+
+    // first thread is finished so the others no longer need to search
+    atomic_store(&workers[0].search.shared->isStopped, true);
+    for (i = 1; i < threads; i += 1)
+    {
+        if (workers[i].isStarted)
+        {
+            thrd_join(workers[i].thread, NULL);
+        }
+    }
+
+    *score = workers[0].score;
+    return workers[0].move;
+}
+
+
+/*
+@context
+    * Searches every move of a lazy search deeper and deeper.
+    * Run by every thread of the search.
+
+@parameters
+    * worker
+        * Thread searching the moves.
+
+@return
+    * Always `0` (required by `thrd_create`).
+*/
+static int runLazy(void *worker)
+{
+    worker_t *self;
+
+    self = worker;
+    self->move = searchDeepening(self->board,
+                                 &self->search,
+                                 self->firstDepth,
+                                 self->maxDepth,
+                                 self->move,
+                                 &self->score);
+
+    return 0;
+}
+
+
+/*
+@context
+    * Adds the statistics of `other` to `search` - both threads of the same
+      parallel search.
+    * Does nothing unless compiled with `SEARCH_STATS` defined.
+
+@parameters
+    * search
+        * Search to add to.
+    * other
+        * Search to add - its time is not added as the threads searched at
+          the same time.
+*/
+static void mergeStats(search_t *search,
+                       search_t *other)
+{
+#ifdef SEARCH_STATS
+    other->stats.time = 0;
+    addStats(&search->stats, &other->stats);
+#else
+    (void)search;
+    (void)other;
+#endif
+}
+
+
+/*
+@context
+    * Adds the statistics of a finished search to the statistics of its
+      engine (set by `setEngineStats`).
+    * Does nothing unless compiled with `SEARCH_STATS` defined.
+
+@parameters
+    * search
+        * Finished search.
+*/
+static void reportStats(search_t *search)
+{
+#ifdef SEARCH_STATS
+    search->stats.searches = 1;
+    search->stats.time = getTime() - search->stats.time;
+
+    if (search->engine->stats != NULL)
+    {
+        addStats(search->engine->stats, &search->stats);
+    }
+#else
+    (void)search;
+#endif
+}
+
+
+/*
+@context
+    * Scores a move just made from the view of the symbol which made it.
+    * Principal variation search - the first move of a state is searched with
+      the whole `alpha` to `beta` window, later moves with a null window only
+      proving they are no better than `alpha` (much cheaper to prune).
+        * A later move proven better is searched again with the whole window
+          to find its score.
+
+@parameters
+    * board
+        * State after the move was made.
+    * search
+        * Search `board` is within.
+    * symbol
+        * Symbol to move next (not the symbol which made the move).
+    * depth
+        * Depth (moves made) of `board` within the minimax search tree.
+    * alpha
+        * Highest score of the symbol which made the move so far.
+    * beta
+        * Lowest score the opponent allows the symbol so far.
+    * isFirst
+        * Indicates if the move is the first searched of its state.
+
+@return
+    * Score of the move for the symbol which made it.
+*/
+static score_t searchMove(board_t  *board,
+                          search_t *search,
+                          char      symbol,
+                          uint8_t   depth,
+                          score_t   alpha,
+                          score_t   beta,
+                          bool      isFirst)
+{
+    score_t score;
+
+    if (isFirst || beta - alpha <= 1)
+    {
+        return -negamax(board, search, symbol, depth, -beta, -alpha);
+    }
+
+    score = -negamax(board, search, symbol, depth, -alpha - 1, -alpha);
+    if (score > alpha && score < beta && !search->isStopped)
+    {
+        score = -negamax(board, search, symbol, depth, -beta, -alpha);
+    }
+
+    return score;
+}
+
+
+/*
+@context
+    * Scores current `board` state for `symbol` which moves next (negamax).
+    * Both symbols play optimally - each maximises its own score which is the
+      negation of the other symbol's score.
 
 @parameters
     * board
         * Current state of the Noughts and Crosses game.
-    * symbolSelf
-        * Symbol to find best move for.
+    * search
+        * Search `board` is within.
+    * symbol
+        * Symbol to move next - the score is for this symbol.
+    * depth
+        * Current depth (moves made) of minimax search tree.
+    * alpha
+        * Highest score of `symbol` within this branch so far.
+    * beta
+        * Lowest score the opponent allows `symbol` within this branch so far.
+        * Finding a score higher than this allows this branch to be pruned.
 
 @return
-    * Cell of the optimal move.
+    * Score of the best `symbol` move at `board` state (within `alpha` and
+      `beta`).
 */
-uint8_t getBestMove(board_t *board,
-                    char     symbolSelf)
+static score_t negamax(board_t  *board,
+                       search_t *search,
+                       char      symbol,
+                       uint8_t   depth,
+                       score_t   alpha,
+                       score_t   beta)
 {
-    uint8_t cell, bestMove;
-    int8_t score, alpha, beta;
+    uint8_t moves[BOARD_MAX_SIZE * BOARD_MAX_SIZE];
+    uint64_t priorities[BOARD_MAX_SIZE * BOARD_MAX_SIZE];
+    score_t score, alphaSearched;
+    uint8_t i, move, count, bestMove, symmetry;
+    uint64_t key;
     char symbolOther;
 
-    // get the symbol of the opponent
-    symbolOther = symbolSelf == NOUGHT ? CROSS : NOUGHT;
+    symbolOther = symbol == NOUGHT ? CROSS : NOUGHT;
 
-    alpha = SCORE_LOSE;
-    beta = SCORE_WIN;
+    // score `board` end state if reached - only the last (other) move can win
+    if (isWin(board, symbolOther))
+    {
+        // penalising `depth` encourages wins using less moves (and losses
+        // using more)
+        return SCORE_LOSE + depth;
+    }
+    else if (isFull(board))
+    {
+        return SCORE_DRAW;
+    }
+    else if (isStopped(search))
+    {
+        return SCORE_DRAW;
+    }
+    else if (depth >= search->maxDepth)
+    {
+        search->isDepthReached = true;
+        return getHeuristicScore(board, symbol);
+    }
+    STATS_NODE(&search->stats, depth);
 
-    // try and score every valid `symbolSelf` move to find next best move
-    for (cell = 0; cell < getSize(board) * getSize(board); cell += 1)
+    // use the stored score of `board` if it was already searched
+    key = getKey(board, symbol, &symmetry);
+    if (probeState(board,
+                   search,
+                   key,
+                   symmetry,
+                   depth,
+                   &alpha,
+                   &beta,
+                   &bestMove))
+    {
+        return alpha;
+    }
+    alphaSearched = alpha;
+
+    // try and score every valid `symbol` move - most likely best first
+    count = getOrderedMoves(&search->ordering,
+                            board,
+                            symbol,
+                            bestMove,
+                            depth,
+                            moves,
+                            priorities);
+    bestMove = MOVE_NONE;
+    for (i = 0; i < count; i += 1)
     {
-        if (isValidMove(board, cell, symbolSelf))
+        // make `symbol` move, score it and unmake the move
+        move = selectMove(moves, priorities, count, i);
+        makeMove(board, move, symbol);
+        score = searchMove(board,
+                           search,
+                           symbolOther,
+                           depth + 1,
+                           alpha,
+                           beta,
+                           i == 0);
+        unmakeMove(board);
+
+        // scores of a stopped search are incomplete so must not be stored
+        if (search->isStopped)
         {
-            // make `symbolSelf` move, `score` it and unmake the move
-            setCell(board, cell, symbolSelf);
-            score = minimise(board, symbolSelf, symbolOther, 1, alpha, beta);
-            setCell(board, cell, EMPTY);
+            return SCORE_DRAW;
+        }
 
-            // current `cell` is a better move than the previous best move
-            if (score > alpha)
-            {
-                alpha = score;
-                bestMove = cell;
-            }
+        if (score > alpha)
+        {
+            alpha = score;
+            bestMove = move;
+        }
+
+        // prune this branch of minimax if the opponent will not allow it
+        if (alpha >= beta)
+        {
+            STATS_CUTOFF(&search->stats, depth, i == 0);
+            updateOrdering(&search->ordering,
+                           symbol,
+                           move,
+                           depth,
+                           getRemainingDepth(board, search, depth));
+            storeState(board,
+                       search,
+                       key,
+                       symmetry,
+                       depth,
+                       alphaSearched,
+                       beta,
+                       alpha,
+                       move);
+            return beta;
         }
     }
 
-    // no best move found - `board` was full - no move possible
-    assert(alpha != SCORE_LOSE);
+    storeState(board,
+               search,
+               key,
+               symmetry,
+               depth,
+               alphaSearched,
+               beta,
+               alpha,
+               bestMove);
+    return alpha;
+}
 
-    return bestMove;
+
+/*
+@context
+    * Counts a state searched and determines if `search` has passed a limit.
+    * Limits are only checked every `NODES_PER_CHECK` states as getting the
+      time and counting states of every thread is slower than searching.
+    * Stops every thread of the search once any thread passes a limit.
+
+@parameters
+    * search
+        * Search to count a state of.
+
+@return
+    * Indicates if `search` is stopped.
+*/
+static bool isStopped(search_t *search)
+{
+    shared_t *shared;
+    uint64_t nodes;
+
+    shared = search->shared;
+
+    search->nodes += 1;
+    if (search->nodes == NODES_PER_CHECK)
+    {
+        search->nodes = 0;
+        nodes = atomic_fetch_add_explicit(&shared->nodes,
+                                          NODES_PER_CHECK,
+                                          memory_order_relaxed)
+            + NODES_PER_CHECK;
+
+        if ((shared->maxNodes > 0 && nodes > shared->maxNodes)
+            || (shared->deadline > 0 && getTime() >= shared->deadline))
+        {
+            atomic_store_explicit(&shared->isStopped,
+                                  true,
+                                  memory_order_relaxed);
+        }
+    }
+
+    search->isStopped = atomic_load_explicit(&shared->isStopped,
+                                             memory_order_relaxed);
+    return search->isStopped;
 }
 
 
-/* ------------------------------- END PUBLIC ------------------------------- */
-/* ----------------------------- START  PRIVATE ----------------------------- */
+/*
+@context
+    * Scores `board` without searching it to the end of every game.
+    * Scored by the threat evaluation of `board` - limited to
+      `SCORE_EVAL_MAX` so it is always between the scores of every loss and
+      every win.
+
+@parameters
+    * board
+        * Current state of the Noughts and Crosses game.
+    * symbol
+        * Symbol to score `board` for.
+
+@return
+    * Heuristic score of `board` - positive when `symbol` is closer to
+      winning.
+*/
+static score_t getHeuristicScore(board_t *board,
+                                 char     symbol)
+{
+    int32_t evaluation;
+
+    evaluation = getEvaluation(board, symbol);
+
+    return min(SCORE_EVAL_MAX, max(-SCORE_EVAL_MAX, evaluation));
+}
+
+
+/*
+@context
+    * Gets the stored best move of `symbol` within `board`.
+    * 3x3 states are found from the opening book or the 3x3 search (which is
+      fast enough to search again), every other state from the transposition
+      table.
+
+@parameters
+    * board
+        * Current state of the Noughts and Crosses game (not ended).
+    * symbol
+        * Symbol to move next.
+    * move
+        * Set to the stored best move.
+
+@return
+    * Indicates if a best move was stored.
+*/
+static bool getStoredMove(engine_t *engine,
+                          board_t  *board,
+                          char      symbol,
+                          uint8_t  *move)
+{
+    entry_t entry;
+    uint8_t symmetry;
+    score_t score;
+
+    if (lookupBook(board, symbol, move, &score))
+    {
+        return true;
+    }
+    if (isBoard3(board))
+    {
+        *move = getBestMove3(board, symbol, NULL, &score);
+        return true;
+    }
+
+    if (engine->table == NULL
+        || !probeTable(engine->table,
+                       getKey(board, symbol, &symmetry),
+                       &entry)
+        || entry.move == MOVE_NONE)
+    {
+        return false;
+    }
+
+    // stored move is of the stored symmetry of `board` so is transformed back
+    *move = transformCell(getSize(board),
+                          entry.move,
+                          invertSymmetry(symmetry));
+    return isValidMove(board, *move, symbol);
+}
 
 
 /*
 @context
-    * Simulates the opponent's (`symbolOther`) turn in current `board` state.
-    * Assumes opponent is optimal - minimise self score (maximise their own).
+    * Determines if `cell` is equivalent to a lower cell through a symmetry.
+    * Equivalent moves have the same score so only the lowest is searched.
 
 @parameters
     * board
         * Current state of the Noughts and Crosses game.
-    * symbolSelf
-        * Symbol to find best move for.
-    * symbolOther
-        * Symbol of opponent.
-        * Placed this turn.
+    * cell
+        * Position in `board` of the move.
+    * symmetries
+        * Symmetries which leave `board` unchanged.
+    * count
+        * Number of `symmetries`.
+
+@return
+    * Indicates if `cell` is equivalent to a lower cell.
+*/
+static bool isEquivalentMove(board_t       *board,
+                             uint8_t        cell,
+                             const uint8_t  symmetries[],
+                             uint8_t        count)
+{
+    uint8_t i;
+
+    for (i = 0; i < count; i += 1)
+    {
+        if (transformCell(getSize(board), cell, symmetries[i]) < cell)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/*
+@context
+    * Narrows the `alpha` and `beta` window using the stored score of `board`.
+    * The stored score is from the transposition table (if initialised).
+    * Stored win and lose scores are relative to the stored state so they are
+      moved back to `depth` as a state can be reached at different depths.
+
+@parameters
+    * board
+        * Current state of the Noughts and Crosses game.
+    * search
+        * Search `board` is within.
+    * key
+        * Key of `board` within the transposition table.
+    * symmetry
+        * Symmetry transforming `board` into the state stored for `key`.
     * depth
         * Current depth (moves made) of minimax search tree.
     * alpha
         * Highest score of this branch so far.
-        * Finding a score lower than this allows this branch to be pruned.
+        * Set to the score to return if the branch can be pruned.
     * beta
         * Lowest score of this branch so far.
+    * move
+        * Set to the stored best move within `board`.
+        * `MOVE_NONE` if no move stored.
 
 @return
-    * Score of the best self move at `board` state.
-        * Opponent minimise the score, so this is the lowest of score this turn.
-        * Provides the score of the move leading to current `board` state.
+    * Indicates if the branch can be pruned (score is `alpha`).
 */
-static int8_t minimise(board_t *board,
-                       char     symbolSelf,
-                       char     symbolOther,
-                       uint8_t  depth,
-                       int8_t   alpha,
-                       int8_t   beta)
+static bool probeState(board_t  *board,
+                       search_t *search,
+                       uint64_t  key,
+                       uint8_t   symmetry,
+                       uint8_t   depth,
+                       score_t  *alpha,
+                       score_t  *beta,
+                       uint8_t  *move)
 {
-    int8_t score;
-    uint8_t cell;
+    entry_t entry;
+    bool isFound;
+    score_t score;
 
-    // score `board` end state if reached - win not possible when minimising
-    if (isWin(board, symbolOther))
+    *move = MOVE_NONE;
+    if (search->engine->table == NULL)
     {
-        // penalising `depth` encourages losses using more moves
-        return SCORE_LOSE + depth;
+        return false;
     }
-    else if (isDraw(board))
+
+    isFound = probeTable(search->engine->table, key, &entry);
+    STATS_PROBE(&search->stats, isFound);
+    if (!isFound)
     {
-        return SCORE_DRAW;
+        return false;
     }
 
-    // try and score every valid `symbolOther` move
-    for (cell = 0; cell < getSize(board) * getSize(board); cell += 1)
+    // stored move is of the stored symmetry of `board` so is transformed back
+    if (entry.move != MOVE_NONE)
     {
-        if (isValidMove(board, cell, symbolOther))
-        {
-            // make `symbolOther` move, `score` it and unmake the move
-            setCell(board, cell, symbolOther);
-            score = maximise(board,
-                             symbolSelf,
-                             symbolOther,
-                             depth + 1,
-                             alpha,
-                             beta);
-            setCell(board, cell, EMPTY);
-
-            // opponent wants to minimise the self `score`
-            beta = min(beta, score);
-
-            // prune this branch of minimax if it cannot have a better score
-            if (beta <= alpha)
-            {
-                return alpha;
-            }
-        }
+        *move = transformCell(getSize(board),
+                              entry.move,
+                              invertSymmetry(symmetry));
+    }
+
+    // stored state must be searched at least as deep as `board` will be
+    if (entry.depth < getRemainingDepth(board, search, depth))
+    {
+        return false;
+    }
+
+    // a stored state not searched to the end of every game was depth limited
+    if (entry.depth < getEmptyCount(board))
+    {
+        search->isDepthReached = true;
+    }
+
+    score = entry.score;
+    if (score > SCORE_EVAL_MAX)
+    {
+        score -= depth;
+    }
+    else if (score < -SCORE_EVAL_MAX)
+    {
+        score += depth;
+    }
+
+    if (entry.bound == BOUND_EXACT)
+    {
+        *alpha = max(*alpha, min(*beta, score));
+        return true;
+    }
+    else if (entry.bound == BOUND_LOWER)
+    {
+        *alpha = max(*alpha, score);
+    }
+    else
+    {
+        *beta = min(*beta, score);
+    }
+
+    // stored bound leaves no scores within the window
+    if (*alpha >= *beta)
+    {
+        *alpha = entry.bound == BOUND_LOWER ? *beta : *alpha;
+        return true;
     }
 
-    return beta;
+    return false;
 }
 
 
 /*
 @context
-    * Simulates the self (`symbolSelf`) turn in current `board` state.
-    * Plays optimally - maximise self score (minimise opponent score).
+    * Stores the `score` of `board` within the transposition table.
+    * Does nothing if the transposition table is not initialised.
+    * Win and lose scores are stored relative to `board` (not the search root).
 
 @parameters
     * board
         * Current state of the Noughts and Crosses game.
-    * symbolSelf
-        * Symbol to find best move for.
-        * Placed in this turn.
-    * symbolOther
-        * Symbol of opponent.
+    * search
+        * Search `board` is within.
+    * key
+        * Key of `board` within the transposition table.
+    * symmetry
+        * Symmetry transforming `board` into the state stored for `key`.
     * depth
         * Current depth (moves made) of minimax search tree.
     * alpha
-        * Highest score of this branch so far.
+        * Highest score of this branch when `board` was searched.
     * beta
-        * Lowest score of this branch so far.
-        * Finding a score higher than this allows this branch to be pruned.
-
-@return
-    * Score of the best self move at `board` state.
-        * Maximises the score, so this is the highest of score this turn.
-        * Provides the score of the move leading to current `board` state.
+        * Lowest score of this branch when `board` was searched.
+    * score
+        * Score found by searching `board`.
+        * Is an upper bound if `<= alpha` and a lower bound if `>= beta`.
+    * move
+        * Best move found in `board`.
 */
-static int8_t maximise(board_t *board,
-                       char     symbolSelf,
-                       char     symbolOther,
-                       uint8_t  depth,
-                       int8_t   alpha,
-                       int8_t   beta)
+static void storeState(board_t  *board,
+                       search_t *search,
+                       uint64_t  key,
+                       uint8_t   symmetry,
+                       uint8_t   depth,
+                       score_t   alpha,
+                       score_t   beta,
+                       score_t   score,
+                       uint8_t   move)
 {
-    int8_t score;
-    uint8_t cell;
+    entry_t entry;
+    score_t stored;
 
-    // score `board` end state if reached - loss not posible when maximising
-    if (isWin(board, symbolSelf))
+    if (search->engine->table == NULL)
     {
-        // penalising `depth` encourages wins using less moves
-        return SCORE_WIN - depth;
+        return;
     }
-    else if (isDraw(board))
+
+    // bounds may pass the score limits once relative - clamping only loosens
+    stored = score;
+    if (score > SCORE_EVAL_MAX)
     {
-        return SCORE_DRAW;
+        stored = stored + depth > SCORE_WIN ? SCORE_WIN : stored + depth;
+    }
+    else if (score < -SCORE_EVAL_MAX)
+    {
+        stored = stored - depth < SCORE_LOSE ? SCORE_LOSE : stored - depth;
     }
+    entry.score = stored;
 
-    // try and score every valid `symbolSelf` move
-    for (cell = 0; cell < getSize(board) * getSize(board); cell += 1)
+    if (score <= alpha)
     {
-        if (isValidMove(board, cell, symbolSelf))
-        {
-            // make `symbolSelf` move, `score` it and unmake the move
-            setCell(board, cell, symbolSelf);
-            score = minimise(board,
-                             symbolSelf,
-                             symbolOther,
-                             depth + 1,
-                             alpha,
-                             beta);
-            setCell(board, cell, EMPTY);
-
-            // want to maximise the self `score`
-            alpha = max(alpha, score);
-
-            // prune this branch of minimax if it cannot have a smaller score
-            if (alpha >= beta)
-            {
-                return beta;
-            }
-        }
+        entry.bound = BOUND_UPPER;
+    }
+    else if (score >= beta)
+    {
+        entry.bound = BOUND_LOWER;
+    }
+    else
+    {
+        entry.bound = BOUND_EXACT;
     }
 
-    return alpha;
+    entry.depth = getRemainingDepth(board, search, depth);
+
+    // every symmetry of `board` shares an entry so store the transformed move
+    entry.move = move;
+    if (move != MOVE_NONE)
+    {
+        entry.move = transformCell(getSize(board), move, symmetry);
+    }
+
+    storeTable(search->engine->table, key, entry);
+}
+
+
+/*
+@context
+    * Gets how many more moves deep `search` searches from `board`.
+
+@parameters
+    * board
+        * Current state of the Noughts and Crosses game.
+    * search
+        * Search `board` is within.
+    * depth
+        * Current depth (moves made) of minimax search tree.
+
+@return
+    * Number of moves deep `board` is searched.
+    * Never more than the number of empty cells (the end of every game).
+*/
+static uint8_t getRemainingDepth(board_t  *board,
+                                 search_t *search,
+                                 uint8_t   depth)
+{
+    uint8_t remaining;
+
+    remaining = search->maxDepth - depth;
+    if (remaining > getEmptyCount(board))
+    {
+        return getEmptyCount(board);
+    }
+    return remaining;
+}
+
+
+/*
+@context
+    * Gets the key of `board` within the transposition table.
+    * Every symmetry of `board` has the same key so they share an entry.
+    * The same cells have different scores depending on who moves next so it
+      is part of the key.
+
+@parameters
+    * board
+        * Current state of the Noughts and Crosses game.
+    * symbol
+        * Symbol to move next (scores are for this symbol).
+    * symmetry
+        * Set to the symmetry transforming `board` into the state of the key.
+
+@return
+    * Key of `board`.
+*/
+static uint64_t getKey(board_t *board,
+                       char     symbol,
+                       uint8_t *symmetry)
+{
+    uint64_t key;
+
+    key = getCanonicalHash(board, symmetry);
+    if (symbol == CROSS)
+    {
+        key ^= KEY_CROSS;
+    }
+
+    return key;
 }
 
 
@@ -258,8 +2471,8 @@ static int8_t maximise(board_t *board,
 @return
     * Minimum value between `a` and `b`.
 */
-static int8_t min(int8_t a,
-                  int8_t b)
+static score_t min(score_t a,
+                   score_t b)
 {
     if (a < b)
     {
@@ -282,8 +2495,8 @@ static int8_t min(int8_t a,
 @return
     * Maximum value between `a` and `b`.
 */
-static int8_t max(int8_t a,
-                  int8_t b)
+static score_t max(score_t a,
+                   score_t b)
 {
     if (a > b)
     {
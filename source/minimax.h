@@ -1,22 +1,136 @@
 /*
 @context
     * Provides a method to find the optimal move of a Noughts and Crosses state.
-    * Uses minimax with alpha-beta pruning.
+    * Uses minimax with alpha-beta pruning (negamax - each symbol maximises
+      its own score).
+        * Moves after the first of each state are searched with a null window
+          (principal variation search) and only searched again if better.
         * Assuming `board` is 3x3, using this method for an entire game will
         only result in a win or draw for the AI (cannot lose).
         * Depth is used to encouraged to win using the least amount of moves.
+    * States are stored in a transposition table so each is searched once.
+        * The table can be saved to a file and loaded (mapped) by later
+          processes so states solved by earlier processes are not searched.
+    * 3x3 states are looked up from an opening book instead when it is built.
+        * Without the book 3x3 states use a specialised 3x3 search.
+    * Searches can be limited by states, time and depth using iterative
+      deepening to find the best move within the limits.
+        * States at the depth limit are scored by the threats of their board.
+    * The principal variation of a search can be followed through the stored
+      best move of each state.
+    * Moves most likely to be the best are searched first so more are pruned.
+    * Limited searches can also be split between threads.
+    * The opponent's turn can be searched in the background (pondering) so
+      the replies to their move are already stored once they have moved.
+    * Statistics of each search are collected when compiled with
+      `SEARCH_STATS` defined.
+    * Every search belongs to an engine - its transposition table, how it
+      searches and the statistics its searches add to.
+        * Engines created by `initEngine` share nothing so any number can
+          search at once (from different threads) without locking.
+        * Functions without an engine use the default engine of the process
+          (its table initialised by `initMinimax`).
 */
 
 
 #ifndef _MINIMAX_H
     #define _MINIMAX_H
 
+    #include <stdbool.h>
     #include <stdint.h>
 
     #include "board.h"
+    #include "ordering.h"
+    #include "score.h"
+    #include "stats.h"
 
 
+    // how the threads of a parallel search share it
+    static const uint8_t PARALLEL_SPLIT = 0;  // root moves split between them
+    static const uint8_t PARALLEL_LAZY = 1;   // share the transposition table
+
+    // entries of the transposition table of an engine unless configured
+    static const uint32_t ENGINE_TABLE_SIZE = 1 << 20;
+
+
+    // limits of a search - `0` for no limit
+    typedef struct
+    {
+        uint64_t nodes;
+        uint32_t time; // milliseconds
+        uint8_t depth;
+    } limits_t;
+
+    // how an engine searches - filled with the defaults by `initEngineConfig`
+    typedef struct
+    {
+        uint32_t tableSize;  // entries of the transposition table (`0` none)
+        limits_t limits;     // no limit searches every game to its end
+        uint8_t threads;     // `0` and `1` search without starting a thread
+        uint8_t mode;        // `PARALLEL_SPLIT` or `PARALLEL_LAZY`
+        uint8_t heuristics;  // `ORDER_` flags ordering every search
+    } engineconfig_t;
+
+    typedef struct engine_s engine_t;
+
+
+    void initEngineConfig(engineconfig_t *config);
+    engine_t *initEngine(const engineconfig_t *config);
+    engine_t *loadEngine(const engineconfig_t *config,
+                         const char           *path);
+    bool saveEngine(engine_t   *engine,
+                    const char *path);
+    void freeEngine(engine_t *engine);
+
+    void setEngineStats(engine_t *engine,
+                        stats_t  *stats);
+
+    uint8_t getEngineMove(engine_t *engine,
+                          board_t  *board,
+                          char      symbolSelf,
+                          score_t  *score);
+    uint8_t getEnginePrincipalVariation(engine_t *engine,
+                                        board_t  *board,
+                                        char      symbolSelf,
+                                        uint8_t   moves[],
+                                        uint8_t   maxMoves);
+
+    void startEnginePondering(engine_t *engine,
+                              board_t  *board,
+                              char      symbolOther);
+    void stopEnginePondering(engine_t *engine);
+
+    void initMinimax(uint32_t tableSize);
+    void freeMinimax();
+    bool loadMinimax(const char *path);
+    bool saveMinimax(const char *path);
+
+    void setOrdering(uint8_t orderHeuristics);
+    void setStats(stats_t *stats);
+
     uint8_t getBestMove(board_t *board,
                         char     symbolSelf);
+    uint8_t getBestMoveScore(board_t *board,
+                             char     symbolSelf,
+                             score_t *score);
+    uint8_t getBestMoveLimited(board_t        *board,
+                               char            symbolSelf,
+                               const limits_t *limits,
+                               score_t        *score);
+    uint8_t getBestMoveParallel(board_t        *board,
+                                char            symbolSelf,
+                                const limits_t *limits,
+                                uint8_t         threads,
+                                uint8_t         mode,
+                                score_t        *score);
+
+    uint8_t getPrincipalVariation(board_t *board,
+                                  char     symbolSelf,
+                                  uint8_t  moves[],
+                                  uint8_t  maxMoves);
+
+    void startPondering(board_t *board,
+                        char     symbolOther);
+    void stopPondering();
 
 #endif
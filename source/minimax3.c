@@ -0,0 +1,449 @@
+#include "minimax3.h"
+
+#include <assert.h>
+#include <stddef.h>
+
+#include "timer.h"
+
+
+// cells of a 3x3 board
+#define CELLS3 9
+#define LINES3 8
+
+static const uint16_t CELLS_FULL = (1 << CELLS3) - 1;
+
+// cells of every row, column and diagonal (bit `n` is cell `n`)
+static const uint16_t LINES[LINES3] =
+{
+    0x007, 0x038, 0x1C0,
+    0x049, 0x092, 0x124,
+    0x111, 0x054
+};
+
+// centre, then corners, then edges - cells within the most lines first
+static const uint8_t ORDER[CELLS3] = {4, 0, 2, 6, 8, 1, 3, 5, 7};
+
+
+// state of a single search - cells only change while searching
+typedef struct
+{
+    uint16_t self;
+    uint16_t other;
+
+#ifdef SEARCH_STATS
+    // time is when the search started until reported
+    stats_t stats;
+#endif
+} search3_t;
+
+
+static score_t minimise(search3_t *search,
+                        uint8_t    depth,
+                        score_t    alpha,
+                        score_t    beta);
+static score_t maximise(search3_t *search,
+                        uint8_t    depth,
+                        score_t    alpha,
+                        score_t    beta);
+static uint8_t getMoves(const search3_t *search,
+                        uint8_t          moves[]);
+static bool isLine(uint16_t cells);
+static bool isLineNext(uint16_t cells,
+                      uint16_t otherCells);
+static score_t min(score_t a,
+                   score_t b);
+static score_t max(score_t a,
+                   score_t b);
+
+
+/* ------------------------------ START PUBLIC ------------------------------ */
+
+
+/*
+@context
+    * Determines if `board` can be searched by `getBestMove3`.
+
+@parameters
+    * board
+        * Board to check.
+
+@return
+    * Whether `board` is 3x3 and won by filling a whole line.
+*/
+bool isBoard3(board_t *board)
+{
+    return getSize(board) == MINIMAX3_SIZE
+        && getLength(board) == MINIMAX3_SIZE;
+}
+
+
+/*
+@context
+    * Finds the optimal move to make with `symbolSelf` in current `board` state
+      and the score of making it (same as `getBestMoveScore`).
+    * Every game is searched to its end with alpha-beta pruning.
+
+@parameters
+    * board
+        * Current state of the Noughts and Crosses game.
+        * Must be 3x3 (`isBoard3`), not ended and not full.
+    * symbolSelf
+        * Symbol to find best move for.
+    * statsTotal
+        * Statistics to add those of the search to - `NULL` for none.
+        * Only added when compiled with `SEARCH_STATS` defined.
+    * score
+        * Set to the score of the optimal move.
+
+@return
+    * Cell of the optimal move.
+*/
+uint8_t getBestMove3(board_t *board,
+                     char     symbolSelf,
+                     stats_t *statsTotal,
+                     score_t *score)
+{
+    search3_t search;
+    uint8_t moves[CELLS3];
+    uint8_t cell, i, move, count, bestMove;
+    score_t alpha, moveScore;
+    char symbol;
+
+    assert(isBoard3(board));
+
+    // cells are only read from `board` once
+    search.self = 0;
+    search.other = 0;
+    for (cell = 0; cell < CELLS3; cell += 1)
+    {
+        symbol = getCell(board, cell);
+        if (symbol == symbolSelf)
+        {
+            search.self |= 1 << cell;
+        }
+        else if (symbol != EMPTY)
+        {
+            search.other |= 1 << cell;
+        }
+    }
+    assert((search.self | search.other) != CELLS_FULL);
+
+#ifdef SEARCH_STATS
+    clearStats(&search.stats);
+    search.stats.time = getTime();
+    STATS_NODE(&search.stats, 0);
+#else
+    (void)statsTotal;
+#endif
+
+    alpha = SCORE_LOSE;
+    count = getMoves(&search, moves);
+    bestMove = moves[0];
+    for (i = 0; i < count; i += 1)
+    {
+        move = moves[i];
+        search.self ^= 1 << move;
+        moveScore = minimise(&search, 1, alpha, SCORE_WIN);
+        search.self ^= 1 << move;
+
+        // every score is above `SCORE_LOSE` so the first move is always set
+        if (moveScore > alpha)
+        {
+            alpha = moveScore;
+            bestMove = move;
+        }
+    }
+
+#ifdef SEARCH_STATS
+    search.stats.searches = 1;
+    search.stats.depth = getEmptyCount(board);
+    search.stats.time = getTime() - search.stats.time;
+    if (statsTotal != NULL)
+    {
+        addStats(statsTotal, &search.stats);
+    }
+#endif
+
+    *score = alpha;
+    return bestMove;
+}
+
+
+/* ------------------------------- END PUBLIC ------------------------------- */
+/* ----------------------------- START  PRIVATE ----------------------------- */
+
+
+/*
+@context
+    * Simulates the opponent's turn (same as `minimise` of the generic search).
+
+@parameters
+    * search
+        * Search the state is within - self has just moved.
+    * depth
+        * Current depth (moves made) of minimax search tree.
+    * alpha
+        * Highest score of this branch so far.
+        * Finding a score lower than this allows this branch to be pruned.
+    * beta
+        * Lowest score of this branch so far.
+
+@return
+    * Score of the best self move at the state.
+*/
+static score_t minimise(search3_t *search,
+                        uint8_t    depth,
+                        score_t    alpha,
+                        score_t    beta)
+{
+    uint8_t moves[CELLS3];
+    uint8_t i, move, count;
+    score_t score;
+
+    if (isLine(search->self))
+    {
+        return SCORE_WIN - depth;
+    }
+    else if ((search->self | search->other) == CELLS_FULL)
+    {
+        return SCORE_DRAW;
+    }
+    STATS_NODE(&search->stats, depth);
+
+    // opponent winning with its next move is the lowest score possible
+    if (isLineNext(search->other, search->self))
+    {
+        return max(alpha, min(beta, SCORE_LOSE + depth + 1));
+    }
+
+    count = getMoves(search, moves);
+    for (i = 0; i < count; i += 1)
+    {
+        move = moves[i];
+        search->other ^= 1 << move;
+        score = maximise(search, depth + 1, alpha, beta);
+        search->other ^= 1 << move;
+
+        if (score < beta)
+        {
+            beta = score;
+        }
+        if (beta <= alpha)
+        {
+            STATS_CUTOFF(&search->stats, depth, i == 0);
+            return alpha;
+        }
+    }
+
+    return beta;
+}
+
+
+/*
+@context
+    * Simulates the self turn (same as `maximise` of the generic search).
+
+@parameters
+    * search
+        * Search the state is within - the opponent has just moved.
+    * depth
+        * Current depth (moves made) of minimax search tree.
+    * alpha
+        * Highest score of this branch so far.
+    * beta
+        * Lowest score of this branch so far.
+        * Finding a score higher than this allows this branch to be pruned.
+
+@return
+    * Score of the best self move at the state.
+*/
+static score_t maximise(search3_t *search,
+                        uint8_t    depth,
+                        score_t    alpha,
+                        score_t    beta)
+{
+    uint8_t moves[CELLS3];
+    uint8_t i, move, count;
+    score_t score;
+
+    if (isLine(search->other))
+    {
+        return SCORE_LOSE + depth;
+    }
+    else if ((search->self | search->other) == CELLS_FULL)
+    {
+        return SCORE_DRAW;
+    }
+    STATS_NODE(&search->stats, depth);
+
+    // winning with the next move is the highest score possible
+    if (isLineNext(search->self, search->other))
+    {
+        return max(alpha, min(beta, SCORE_WIN - (depth + 1)));
+    }
+
+    count = getMoves(search, moves);
+    for (i = 0; i < count; i += 1)
+    {
+        move = moves[i];
+        search->self ^= 1 << move;
+        score = minimise(search, depth + 1, alpha, beta);
+        search->self ^= 1 << move;
+
+        if (score > alpha)
+        {
+            alpha = score;
+        }
+        if (alpha >= beta)
+        {
+            STATS_CUTOFF(&search->stats, depth, i == 0);
+            return beta;
+        }
+    }
+
+    return alpha;
+}
+
+
+/*
+@context
+    * Gets every empty cell of a search in the order to score them.
+
+@parameters
+    * search
+        * Search to get the empty cells of.
+    * moves
+        * Filled with the empty cells.
+
+@return
+    * Number of `moves`.
+*/
+static uint8_t getMoves(const search3_t *search,
+                        uint8_t          moves[])
+{
+    uint8_t i, count;
+
+    count = 0;
+    for (i = 0; i < CELLS3; i += 1)
+    {
+        if (!((search->self | search->other) & (1 << ORDER[i])))
+        {
+            moves[count] = ORDER[i];
+            count += 1;
+        }
+    }
+
+    return count;
+}
+
+
+/*
+@context
+    * Determines if `cells` fill any row, column or diagonal.
+
+@parameters
+    * cells
+        * Cells of a symbol.
+
+@return
+    * Whether `cells` win.
+*/
+static bool isLine(uint16_t cells)
+{
+    uint8_t line;
+
+    for (line = 0; line < LINES3; line += 1)
+    {
+        if ((cells & LINES[line]) == LINES[line])
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/*
+@context
+    * Determines if `cells` can fill a row, column or diagonal with 1 move.
+
+@parameters
+    * cells
+        * Cells of the symbol to move.
+    * otherCells
+        * Cells of the other symbol.
+
+@return
+    * Whether a line has every cell but 1 within `cells` and the last empty.
+*/
+static bool isLineNext(uint16_t cells,
+                      uint16_t otherCells)
+{
+    uint16_t missing;
+    uint8_t line;
+
+    for (line = 0; line < LINES3; line += 1)
+    {
+        // exactly 1 cell of the line is missing and it is empty
+        missing = LINES[line] & ~cells;
+        if (missing != 0 && (missing & (missing - 1)) == 0
+            && !(missing & otherCells))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/*
+@context
+    * Gets the minimum value between `a` and `b`.
+
+@parameters
+    * a
+        * Value to return if smaller than `b`.
+    * b
+        * Value to return if smaller than `a`.
+
+@return
+    * Minimum value between `a` and `b`.
+*/
+static score_t min(score_t a,
+                   score_t b)
+{
+    if (a < b)
+    {
+        return a;
+    }
+    return b;
+}
+
+
+/*
+@context
+    * Gets the maximum value between `a` and `b`.
+
+@parameters
+    * a
+        * Value to return if larger than `b`.
+    * b
+        * Value to return if larger than `a`.
+
+@return
+    * Maximum value between `a` and `b`.
+*/
+static score_t max(score_t a,
+                   score_t b)
+{
+    if (a > b)
+    {
+        return a;
+    }
+    return b;
+}
+
+
+/* ------------------------------ END  PRIVATE ------------------------------ */
@@ -0,0 +1,35 @@
+/*
+@context
+    * Provides a search specialised for the standard game - 3x3 boards won by
+      filling a whole row, column or diagonal.
+    * The size and the masks of every win line are compile time constants and
+      cells are kept as a 9 bit mask of each symbol, so the loops over cells
+      and lines have constant bounds (unrolled by the compiler) and no board
+      accessor is called while searching.
+    * Scores are the same as the generic search (`getBestMoveScore`) which
+      uses this for every 3x3 board not found in the opening book.
+*/
+
+
+#ifndef _MINIMAX3_H
+    #define _MINIMAX3_H
+
+    #include <stdbool.h>
+    #include <stdint.h>
+
+    #include "board.h"
+    #include "score.h"
+    #include "stats.h"
+
+
+    static const uint8_t MINIMAX3_SIZE = 3;
+
+
+    bool isBoard3(board_t *board);
+
+    uint8_t getBestMove3(board_t *board,
+                         char     symbolSelf,
+                         stats_t *statsTotal,
+                         score_t *score);
+
+#endif
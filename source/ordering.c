@@ -0,0 +1,365 @@
+#include "ordering.h"
+
+#include <string.h>
+
+
+// no move stored as a killer
+static const uint8_t KILLER_NONE = UINT8_MAX;
+
+// priority of a move is its class, then its history and then its centre
+static const uint8_t PRIORITY_CLASS_SHIFT = 56;
+static const uint8_t PRIORITY_HISTORY_SHIFT = 16;
+static const uint64_t PRIORITY_HISTORY_MAX = ((uint64_t)1 << 40) - 1;
+
+// classes of moves searched before every other move
+static const uint64_t CLASS_TABLE = ORDERING_KILLERS + 1;
+
+
+static uint8_t getCandidates(ordering_t *ordering,
+                             board_t    *board,
+                             char        symbol,
+                             uint8_t     moves[]);
+static uint16_t getCentre(board_t *board,
+                          uint8_t  cell);
+static uint8_t getSymbolIndex(char symbol);
+
+
+/* ------------------------------ START PUBLIC ------------------------------ */
+
+
+/*
+@context
+    * Initialises the move ordering of a search.
+    * No moves have pruned a branch yet so only the static priorities are set.
+
+@parameters
+    * ordering
+        * Move ordering to initialise.
+    * board
+        * Board to search.
+    * heuristics
+        * Heuristics used to order moves (`ORDER_` flags combined).
+*/
+void initOrdering(ordering_t *ordering,
+                  board_t    *board,
+                  uint8_t     heuristics)
+{
+    uint8_t cell;
+
+    ordering->heuristics = heuristics;
+
+    memset(ordering->killers, KILLER_NONE, sizeof(ordering->killers));
+    memset(ordering->history, 0, sizeof(ordering->history));
+
+    for (cell = 0; cell < getSize(board) * getSize(board); cell += 1)
+    {
+        ordering->centre[cell] = getCentre(board, cell);
+    }
+}
+
+
+/*
+@context
+    * Gets every valid `symbol` move within `board` not pruned by
+      `ORDER_FORCED` or `ORDER_NEAR` and their priorities.
+    * Moves are in cell order - `selectMove` gets them in priority order.
+
+@parameters
+    * ordering
+        * Move ordering of the search `board` is within.
+    * board
+        * Current state of the Noughts and Crosses game.
+    * symbol
+        * Symbol to place.
+    * firstMove
+        * Move likely to be the best (stored or from a previous search).
+        * Ignored if `UINT8_MAX` or `ORDER_TABLE` is not used.
+    * depth
+        * Current depth (moves made) of the search.
+    * moves
+        * Filled with the cell of every move to search.
+        * Requires space for every cell of `board`.
+    * priorities
+        * Filled with the priority of each of `moves` (higher first).
+        * Requires space for every cell of `board`.
+
+@return
+    * Number of moves to search.
+*/
+uint8_t getOrderedMoves(ordering_t *ordering,
+                        board_t    *board,
+                        char        symbol,
+                        uint8_t     firstMove,
+                        uint8_t     depth,
+                        uint8_t     moves[],
+                        uint64_t    priorities[])
+{
+    const uint64_t *history;
+    uint64_t priority;
+    uint8_t cell, count, move, i;
+
+    history = ordering->history[getSymbolIndex(symbol)];
+
+    count = getCandidates(ordering, board, symbol, moves);
+    for (move = 0; move < count; move += 1)
+    {
+        cell = moves[move];
+
+        priority = 0;
+        if (ordering->heuristics & ORDER_CENTRE)
+        {
+            priority = ordering->centre[cell];
+        }
+        if (ordering->heuristics & ORDER_HISTORY)
+        {
+            priority |= (history[cell] < PRIORITY_HISTORY_MAX
+                         ? history[cell]
+                         : PRIORITY_HISTORY_MAX) << PRIORITY_HISTORY_SHIFT;
+        }
+
+        if ((ordering->heuristics & ORDER_TABLE) && cell == firstMove)
+        {
+            priority |= CLASS_TABLE << PRIORITY_CLASS_SHIFT;
+        }
+        else if (ordering->heuristics & ORDER_KILLERS)
+        {
+            // more recent killers are more likely to prune again
+            for (i = 0; i < ORDERING_KILLERS; i += 1)
+            {
+                if (ordering->killers[depth][i] == cell)
+                {
+                    priority |= (uint64_t)(ORDERING_KILLERS - i)
+                                << PRIORITY_CLASS_SHIFT;
+                    break;
+                }
+            }
+        }
+
+        priorities[move] = priority;
+    }
+
+    return count;
+}
+
+
+/*
+@context
+    * Gets the move to search at `index` - the highest priority move not yet
+      searched.
+    * Moves are selected one at a time as a pruned branch does not search the
+      rest (sorting them would be wasted).
+    * Moves with the same priority are selected in their order in `moves`.
+
+@parameters
+    * moves
+        * Moves from `getOrderedMoves`.
+        * Moves before `index` are already searched.
+        * The selected move is moved to `index`.
+    * priorities
+        * Priority of each of `moves`.
+        * Reordered the same as `moves`.
+    * count
+        * Number of `moves`.
+    * index
+        * Number of moves already searched.
+
+@return
+    * Cell of the move to search.
+*/
+uint8_t selectMove(uint8_t  moves[],
+                   uint64_t priorities[],
+                   uint8_t  count,
+                   uint8_t  index)
+{
+    uint64_t priority;
+    uint8_t i, best, move;
+
+    best = index;
+    for (i = index + 1; i < count; i += 1)
+    {
+        if (priorities[i] > priorities[best])
+        {
+            best = i;
+        }
+    }
+
+    // shift the skipped moves along so their order is kept
+    move = moves[best];
+    priority = priorities[best];
+    for (i = best; i > index; i -= 1)
+    {
+        moves[i] = moves[i - 1];
+        priorities[i] = priorities[i - 1];
+    }
+    moves[index] = move;
+    priorities[index] = priority;
+
+    return move;
+}
+
+
+/*
+@context
+    * Records that `move` pruned a branch so it is searched earlier next time.
+
+@parameters
+    * ordering
+        * Move ordering of the search the branch is within.
+    * symbol
+        * Symbol placed by `move`.
+    * move
+        * Cell of the move which pruned the branch.
+    * depth
+        * Depth (moves made) of the state `move` was made in.
+    * remaining
+        * How many more moves deep the state was searched.
+        * Pruning deeper branches saves more so is weighted higher.
+*/
+void updateOrdering(ordering_t *ordering,
+                    char        symbol,
+                    uint8_t     move,
+                    uint8_t     depth,
+                    uint8_t     remaining)
+{
+    uint8_t *killers;
+    uint8_t i;
+
+    killers = ordering->killers[depth];
+    if (killers[0] != move)
+    {
+        for (i = ORDERING_KILLERS - 1; i > 0; i -= 1)
+        {
+            killers[i] = killers[i - 1];
+        }
+        killers[0] = move;
+    }
+
+    ordering->history[getSymbolIndex(symbol)][move] +=
+        (uint64_t)remaining * remaining;
+}
+
+
+/* ------------------------------- END PUBLIC ------------------------------- */
+/* ----------------------------- START  PRIVATE ----------------------------- */
+
+
+/*
+@context
+    * Gets the cells of the moves of `symbol` to search in cell order - every
+      valid move not pruned by `ORDER_FORCED` or `ORDER_NEAR`.
+
+@parameters
+    * ordering
+        * Move ordering of the search `board` is within.
+    * board
+        * Current state of the Noughts and Crosses game.
+    * symbol
+        * Symbol to place.
+    * moves
+        * Filled with the cell of every move to search.
+        * Requires space for every cell of `board`.
+
+@return
+    * Number of moves to search.
+*/
+static uint8_t getCandidates(ordering_t *ordering,
+                             board_t    *board,
+                             char        symbol,
+                             uint8_t     moves[])
+{
+    uint8_t cell, count;
+    char opponent;
+
+    opponent = symbol == NOUGHT ? CROSS : NOUGHT;
+    if (ordering->heuristics & ORDER_FORCED)
+    {
+        // a win is the soonest so 1 is as good as any other move
+        if (getWinningMoves(board, symbol, moves) > 0)
+        {
+            return 1;
+        }
+
+        // every other move loses next move - the soonest a loss can be
+        count = getWinningMoves(board, opponent, moves);
+        if (count > 0)
+        {
+            return count;
+        }
+    }
+
+    // an empty board has no cells near a filled cell so every move is kept
+    if ((ordering->heuristics & ORDER_NEAR)
+        && getSize(board) >= ORDERING_NEAR_SIZE)
+    {
+        count = getNearMoves(board, ORDERING_NEAR_DISTANCE, moves);
+        if (count > 0)
+        {
+            return count;
+        }
+    }
+
+    count = 0;
+    for (cell = 0; cell < getSize(board) * getSize(board); cell += 1)
+    {
+        if (isValidMove(board, cell, symbol))
+        {
+            moves[count] = cell;
+            count += 1;
+        }
+    }
+
+    return count;
+}
+
+
+/*
+@context
+    * Gets the static priority of `cell` - higher for cells more likely to be
+      the best move before searching.
+    * Cells within more windows (centre and corners of 3x3) are first, then
+      cells nearer the centre.
+
+@parameters
+    * board
+        * Board `cell` is within.
+    * cell
+        * Position in `board`.
+
+@return
+    * Static priority of `cell`.
+*/
+static uint16_t getCentre(board_t *board,
+                          uint8_t  cell)
+{
+    uint8_t size, row, col, distance;
+
+    size = getSize(board);
+    row = cell / size;
+    col = cell % size;
+
+    // distance doubled so the centre between cells of even boards is whole
+    distance = (2 * row > size - 1 ? 2 * row - (size - 1) : size - 1 - 2 * row)
+        + (2 * col > size - 1 ? 2 * col - (size - 1) : size - 1 - 2 * col);
+
+    return (getWindowCount(board, cell) * 64) + (63 - distance);
+}
+
+
+/*
+@context
+    * Gets the index of `symbol` within the history of each symbol.
+
+@parameters
+    * symbol
+        * Symbol to get the index of.
+
+@return
+    * Index of `symbol`.
+*/
+static uint8_t getSymbolIndex(char symbol)
+{
+    return symbol == NOUGHT ? 0 : 1;
+}
+
+
+/* ------------------------------ END  PRIVATE ------------------------------ */
@@ -0,0 +1,87 @@
+/*
+@context
+    * Provides the order to search moves so the best move is likely first.
+    * Searching the best move first lets alpha-beta prune the most branches.
+    * Moves are ordered by a combination of heuristics.
+        * `ORDER_TABLE` - best move stored for the state (or of a previous
+          search) first.
+        * `ORDER_KILLERS` - moves which pruned a branch at the same depth.
+        * `ORDER_HISTORY` - moves which pruned the most (deepest) branches.
+        * `ORDER_CENTRE` - cells within the most windows (can be part of the
+          most wins) and nearest the centre.
+    * Moves can also be pruned before they are ordered.
+        * `ORDER_FORCED` - only a winning move if there is one, otherwise only
+          the moves blocking the opponent's wins if there are any - every
+          other move loses sooner (or wins later) so the score is unchanged.
+        * `ORDER_NEAR` - only cells near a filled cell on large boards - far
+          cells are very unlikely to be the best so are not searched (as a
+          heuristic this can change the score).
+    * Moves with the same priority are kept in cell order.
+*/
+
+
+#ifndef _ORDERING_H
+    #define _ORDERING_H
+
+    #include <stdint.h>
+
+    #include "board.h"
+
+
+    #define ORDERING_CELLS (BOARD_MAX_SIZE * BOARD_MAX_SIZE)
+    #define ORDERING_KILLERS 2
+
+    // smallest board `ORDER_NEAR` prunes and most rows (and columns) a move
+    // can be from a filled cell
+    static const uint8_t ORDERING_NEAR_SIZE = 7;
+    static const uint8_t ORDERING_NEAR_DISTANCE = 2;
+
+    // heuristics used to order moves - combined as flags
+    static const uint8_t ORDER_NONE = 0;
+    static const uint8_t ORDER_TABLE = 1;
+    static const uint8_t ORDER_KILLERS = 2;
+    static const uint8_t ORDER_HISTORY = 4;
+    static const uint8_t ORDER_CENTRE = 8;
+    static const uint8_t ORDER_FORCED = 16;
+    static const uint8_t ORDER_NEAR = 32;
+    static const uint8_t ORDER_ALL = 63;
+
+
+    typedef struct
+    {
+        uint8_t heuristics;
+
+        // moves which last pruned a branch at each depth (most recent first)
+        uint8_t killers[ORDERING_CELLS + 1][ORDERING_KILLERS];
+
+        // how much each move of each symbol pruned
+        uint64_t history[2][ORDERING_CELLS];
+
+        // static priority of each cell of the board being searched
+        uint16_t centre[ORDERING_CELLS];
+    } ordering_t;
+
+
+    void initOrdering(ordering_t *ordering,
+                      board_t    *board,
+                      uint8_t     heuristics);
+
+    uint8_t getOrderedMoves(ordering_t *ordering,
+                            board_t    *board,
+                            char        symbol,
+                            uint8_t     firstMove,
+                            uint8_t     depth,
+                            uint8_t     moves[],
+                            uint64_t    priorities[]);
+    uint8_t selectMove(uint8_t  moves[],
+                       uint64_t priorities[],
+                       uint8_t  count,
+                       uint8_t  index);
+
+    void updateOrdering(ordering_t *ordering,
+                        char        symbol,
+                        uint8_t     move,
+                        uint8_t     depth,
+                        uint8_t     remaining);
+
+#endif
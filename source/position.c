@@ -0,0 +1,449 @@
+#include "position.h"
+
+#include <assert.h>
+#include <string.h>
+
+
+// cells held within each word and the bits of each cell
+static const uint8_t CELLS_PER_WORD = 32;
+static const uint64_t CELL_MASK = 3;
+
+static const uint64_t CELL_EMPTY = 0;
+static const uint64_t CELL_NOUGHT = 1;
+static const uint64_t CELL_CROSS = 2;
+
+// start of every position file (followed by `POSITION_FILE_VERSION`)
+static const char FILE_MAGIC[4] = {'N', 'C', 'P', 'S'};
+
+// bytes before the cells of each position within a file and cells packed
+// into each byte
+#define RECORD_HEAD_BYTES 2
+static const uint8_t CELLS_PER_BYTE = 4;
+
+// most bytes of a position within a file
+#define RECORD_MAX_BYTES \
+    (RECORD_HEAD_BYTES + (((BOARD_MAX_SIZE * BOARD_MAX_SIZE) + 3) / 4))
+
+
+static uint64_t getCellValue(char symbol);
+
+
+/* ------------------------------ START PUBLIC ------------------------------ */
+
+
+/*
+@context
+    * Initialises a position with every cell empty.
+
+@parameters
+    * position
+        * Position to initialise.
+    * size
+        * Width and height of the board of the position.
+    * length
+        * Number of consecutive cells to win.
+    * symbol
+        * Symbol to move next.
+*/
+void initPosition(position_t *position,
+                  uint8_t     size,
+                  uint8_t     length,
+                  char        symbol)
+{
+    uint8_t word;
+
+    assert(size > 0 && size <= BOARD_MAX_SIZE);
+    assert(length > 0 && length <= size);
+    assert(symbol == NOUGHT || symbol == CROSS);
+
+    position->size = size;
+    position->length = length;
+    position->symbol = symbol;
+
+    for (word = 0; word < POSITION_WORDS; word += 1)
+    {
+        position->cells[word] = CELL_EMPTY;
+    }
+}
+
+
+/*
+@context
+    * Encodes the cells of `board` into a position.
+
+@parameters
+    * board
+        * Board to encode.
+    * symbol
+        * Symbol to move next.
+    * position
+        * Set to the position of `board`.
+*/
+void encodePosition(board_t    *board,
+                    char        symbol,
+                    position_t *position)
+{
+    uint64_t word;
+    uint8_t cell, cells;
+
+    initPosition(position, getSize(board), getLength(board), symbol);
+
+    // each word is built before being stored instead of a cell at a time
+    cells = getSize(board) * getSize(board);
+    word = 0;
+    for (cell = 0; cell < cells; cell += 1)
+    {
+        word |= getCellValue(getCell(board, cell))
+            << (2 * (cell % CELLS_PER_WORD));
+        if (cell % CELLS_PER_WORD == CELLS_PER_WORD - 1 || cell + 1 == cells)
+        {
+            position->cells[cell / CELLS_PER_WORD] = word;
+            word = 0;
+        }
+    }
+}
+
+
+/*
+@context
+    * Sets the cells of `board` to the cells of `position`.
+    * Only cells which differ are changed so decoding similar positions into
+      the same board is cheaper than resetting it.
+
+@parameters
+    * position
+        * Position to decode.
+    * board
+        * Board to set the cells of.
+        * Must have the same size and win length as `position`.
+*/
+void decodePosition(const position_t *position,
+                    board_t          *board)
+{
+    uint8_t cell;
+    char symbol;
+
+    assert(getSize(board) == position->size);
+    assert(getLength(board) == position->length);
+
+    for (cell = 0; cell < position->size * position->size; cell += 1)
+    {
+        symbol = getPositionCell(position, cell);
+        if (getCell(board, cell) == symbol)
+        {
+            continue;
+        }
+
+        // a symbol can only be placed on an empty cell
+        if (getCell(board, cell) != EMPTY)
+        {
+            setCell(board, cell, EMPTY);
+        }
+        if (symbol != EMPTY)
+        {
+            setCell(board, cell, symbol);
+        }
+    }
+}
+
+
+/*
+@context
+    * Gets the symbol at `cell` within `position`.
+
+@parameters
+    * position
+        * Position to get the `cell` of.
+    * cell
+        * Cell of the board of `position`.
+
+@return
+    * Symbol at `cell`.
+*/
+char getPositionCell(const position_t *position,
+                     uint8_t           cell)
+{
+    uint64_t value;
+
+    assert(cell < position->size * position->size);
+
+    value = (position->cells[cell / CELLS_PER_WORD]
+             >> (2 * (cell % CELLS_PER_WORD))) & CELL_MASK;
+
+    if (value == CELL_NOUGHT)
+    {
+        return NOUGHT;
+    }
+    else if (value == CELL_CROSS)
+    {
+        return CROSS;
+    }
+    return EMPTY;
+}
+
+
+/*
+@context
+    * Sets `cell` within `position` to `symbol`.
+
+@parameters
+    * position
+        * Position to set the `cell` of.
+    * cell
+        * Cell of the board of `position`.
+    * symbol
+        * Symbol to set `cell` to.
+        * Only `NOUGHT`, `CROSS` or `EMPTY` allowed.
+*/
+void setPositionCell(position_t *position,
+                     uint8_t     cell,
+                     char        symbol)
+{
+    uint64_t value, *word;
+    uint8_t shift;
+
+    assert(cell < position->size * position->size);
+    assert(symbol == NOUGHT || symbol == CROSS || symbol == EMPTY);
+
+    value = getCellValue(symbol);
+
+    word = &position->cells[cell / CELLS_PER_WORD];
+    shift = 2 * (cell % CELLS_PER_WORD);
+    *word = (*word & ~(CELL_MASK << shift)) | (value << shift);
+}
+
+
+/*
+@context
+    * Gets the base 3 index of `position` - each cell is a digit (`0` empty,
+      `1` nought and `2` cross) with the first cell the lowest.
+    * Indexes every arrangement of the cells of the board from `0` to
+      `3^cells - 1` (the size, win length and symbol to move are not part
+      of it).
+
+@parameters
+    * position
+        * Position of a board of up to `POSITION_INDEX_MAX_CELLS` cells.
+
+@return
+    * Index of the cells of `position`.
+*/
+uint64_t getPositionIndex(const position_t *position)
+{
+    uint64_t index;
+    uint8_t cell;
+
+    assert(position->size * position->size <= POSITION_INDEX_MAX_CELLS);
+
+    index = 0;
+    for (cell = position->size * position->size; cell > 0; cell -= 1)
+    {
+        index = (index * 3)
+            + ((position->cells[(cell - 1) / CELLS_PER_WORD]
+                >> (2 * ((cell - 1) % CELLS_PER_WORD))) & CELL_MASK);
+    }
+
+    return index;
+}
+
+
+/*
+@context
+    * Sets the cells of `position` to those of a base 3 index (from
+      `getPositionIndex`) - the size, win length and symbol to move are
+      kept.
+
+@parameters
+    * position
+        * Position of a board of up to `POSITION_INDEX_MAX_CELLS` cells.
+    * index
+        * Index of the cells.
+        * Must be less than `3^cells`.
+*/
+void setPositionIndex(position_t *position,
+                      uint64_t    index)
+{
+    uint8_t cell, word;
+
+    assert(position->size * position->size <= POSITION_INDEX_MAX_CELLS);
+
+    for (word = 0; word < POSITION_WORDS; word += 1)
+    {
+        position->cells[word] = CELL_EMPTY;
+    }
+
+    for (cell = 0; cell < position->size * position->size; cell += 1)
+    {
+        position->cells[cell / CELLS_PER_WORD] |=
+            (index % 3) << (2 * (cell % CELLS_PER_WORD));
+        index /= 3;
+    }
+
+    assert(index == 0);
+}
+
+
+/*
+@context
+    * Writes the header of a position file - written once before every
+      position.
+
+@parameters
+    * file
+        * Stream to write to (opened in binary mode).
+
+@return
+    * Indicates if the header was written.
+*/
+bool writePositionHeader(FILE *file)
+{
+    return fwrite(FILE_MAGIC, sizeof(FILE_MAGIC), 1, file) == 1
+        && fputc(POSITION_FILE_VERSION, file) != EOF;
+}
+
+
+/*
+@context
+    * Reads the header of a position file - read once before every position.
+
+@parameters
+    * file
+        * Stream to read from (opened in binary mode).
+
+@return
+    * Indicates if the header was read and is of this version.
+*/
+bool readPositionHeader(FILE *file)
+{
+    char magic[sizeof(FILE_MAGIC)];
+
+    return fread(magic, sizeof(magic), 1, file) == 1
+        && memcmp(magic, FILE_MAGIC, sizeof(FILE_MAGIC)) == 0
+        && fgetc(file) == POSITION_FILE_VERSION;
+}
+
+
+/*
+@context
+    * Writes `position` to a position file.
+    * Cells are packed 4 to a byte as they are within a position so every
+      position of a board takes the same number of bytes.
+
+@parameters
+    * file
+        * Stream to write to (after the header).
+    * position
+        * Position to write.
+
+@return
+    * Indicates if the whole position was written.
+*/
+bool writePosition(FILE             *file,
+                   const position_t *position)
+{
+    uint8_t record[RECORD_MAX_BYTES];
+    uint8_t cells, bytes, i;
+
+    cells = position->size * position->size;
+    bytes = RECORD_HEAD_BYTES + ((cells + CELLS_PER_BYTE - 1) / CELLS_PER_BYTE);
+
+    // size and win length both fit 4 bits
+    record[0] = (position->size - 1) | ((position->length - 1) << 4);
+    record[1] = position->symbol == NOUGHT ? 0 : 1;
+
+    for (i = RECORD_HEAD_BYTES; i < bytes; i += 1)
+    {
+        record[i] = position->cells[(i - RECORD_HEAD_BYTES) / 8]
+            >> (8 * ((i - RECORD_HEAD_BYTES) % 8));
+    }
+
+    return fwrite(record, bytes, 1, file) == 1;
+}
+
+
+/*
+@context
+    * Reads the next position of a position file.
+
+@parameters
+    * file
+        * Stream to read from (after the header).
+    * position
+        * Set to the position read.
+
+@return
+    * Indicates if a valid position was read.
+    * `false` once the file ends or if the position is not valid.
+*/
+bool readPosition(FILE       *file,
+                  position_t *position)
+{
+    uint8_t record[RECORD_MAX_BYTES];
+    uint8_t size, length, cells, bytes, cell, i;
+    uint64_t value;
+
+    if (fread(record, RECORD_HEAD_BYTES, 1, file) != 1)
+    {
+        return false;
+    }
+
+    size = (record[0] & 15) + 1;
+    length = (record[0] >> 4) + 1;
+    if (size > BOARD_MAX_SIZE || length > size || record[1] > 1)
+    {
+        return false;
+    }
+
+    cells = size * size;
+    bytes = (cells + CELLS_PER_BYTE - 1) / CELLS_PER_BYTE;
+    if (fread(&record[RECORD_HEAD_BYTES], bytes, 1, file) != 1)
+    {
+        return false;
+    }
+
+    initPosition(position, size, length, record[1] == 0 ? NOUGHT : CROSS);
+    for (i = 0; i < bytes; i += 1)
+    {
+        position->cells[i / 8] |=
+            (uint64_t)record[RECORD_HEAD_BYTES + i] << (8 * (i % 8));
+    }
+
+    // every cell is a symbol and bits past the last cell are unset
+    for (cell = 0; cell < bytes * CELLS_PER_BYTE; cell += 1)
+    {
+        value = (position->cells[cell / CELLS_PER_WORD]
+                 >> (2 * (cell % CELLS_PER_WORD))) & CELL_MASK;
+        if (value > CELL_CROSS || (cell >= cells && value != CELL_EMPTY))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+/* ------------------------------- END PUBLIC ------------------------------- */
+/* ----------------------------- START  PRIVATE ----------------------------- */
+
+
+/*
+@context
+    * Gets the 2 bits of `symbol` within a position.
+
+@parameters
+    * symbol
+        * Symbol to get the bits of.
+        * Only `NOUGHT`, `CROSS` or `EMPTY` allowed.
+
+@return
+    * Bits of `symbol`.
+*/
+static uint64_t getCellValue(char symbol)
+{
+    return symbol == NOUGHT ? CELL_NOUGHT
+        : symbol == CROSS ? CELL_CROSS : CELL_EMPTY;
+}
+
+
+/* ------------------------------ END  PRIVATE ------------------------------ */
@@ -0,0 +1,77 @@
+/*
+@context
+    * Provides a compact position of a Noughts and Crosses game.
+    * Unlike a board, a position is a plain value - it is not allocated and
+      can be copied, stored in arrays and passed between threads freely.
+    * Each cell is 2 bits (`0` empty, `1` nought and `2` cross) packed 32 to a
+      word where the first cell is the lowest bits of the first word.
+    * Includes the size and win length of its board and the symbol to move.
+    * Positions of boards of up to `POSITION_INDEX_MAX_CELLS` cells also have
+      a base 3 index (each cell a digit, the first cell the lowest) - the
+      same as the index of a 3x3 state within the opening book.
+    * Positions can be streamed to and from files of any length.
+        * A file is a header (magic and version) then each position as
+          2 bytes (size and win length, then the symbol to move) and its
+          cells packed 4 to a byte - 6 bytes for a 3x3 position.
+*/
+
+
+#ifndef _POSITION_H
+    #define _POSITION_H
+
+    #include <stdbool.h>
+    #include <stdint.h>
+    #include <stdio.h>
+
+    #include "board.h"
+
+
+    // words to hold 2 bits for every cell of the largest board
+    #define POSITION_WORDS \
+        (((BOARD_MAX_SIZE * BOARD_MAX_SIZE * 2) + 63) / 64)
+
+    // most cells of a board with a base 3 index (3^40 fits 64 bits)
+    static const uint8_t POSITION_INDEX_MAX_CELLS = 40;
+
+    // version of the position files written by `writePositionHeader`
+    static const uint8_t POSITION_FILE_VERSION = 1;
+
+
+    typedef struct
+    {
+        uint8_t size;
+        uint8_t length;
+        char symbol;
+        uint64_t cells[POSITION_WORDS];
+    } position_t;
+
+
+    void initPosition(position_t *position,
+                      uint8_t     size,
+                      uint8_t     length,
+                      char        symbol);
+
+    void encodePosition(board_t    *board,
+                        char        symbol,
+                        position_t *position);
+    void decodePosition(const position_t *position,
+                        board_t          *board);
+
+    char getPositionCell(const position_t *position,
+                         uint8_t           cell);
+    void setPositionCell(position_t *position,
+                         uint8_t     cell,
+                         char        symbol);
+
+    uint64_t getPositionIndex(const position_t *position);
+    void setPositionIndex(position_t *position,
+                          uint64_t    index);
+
+    bool writePositionHeader(FILE *file);
+    bool readPositionHeader(FILE *file);
+    bool writePosition(FILE             *file,
+                       const position_t *position);
+    bool readPosition(FILE       *file,
+                      position_t *position);
+
+#endif
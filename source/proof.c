@@ -0,0 +1,525 @@
+#include "proof.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "timer.h"
+
+
+// proof or disproof number of a state already proved or disproved
+static const uint32_t PROOF_INFINITE = UINT32_MAX;
+
+// same as the minimax search - each state is keyed by who moves next
+static const uint64_t KEY_CROSS = 0x9E6C63D0676A9A99;
+
+// states searched between checking if the time limit has passed
+static const uint64_t NODES_PER_CHECK = 1024;
+
+
+// proof and disproof numbers of a state (`0` once proved or disproved)
+typedef struct
+{
+    uint32_t proof;
+    uint32_t disproof;
+} numbers_t;
+
+// numbers of the state identified by `key` - unused while both are `0`
+typedef struct
+{
+    uint64_t key;
+    numbers_t numbers;
+} proofentry_t;
+
+// state of a single proof
+typedef struct
+{
+    board_t *board;
+    char symbolSelf;
+
+    // cells in the order to try them - cells within more windows first
+    uint8_t order[BOARD_MAX_SIZE * BOARD_MAX_SIZE];
+
+    // number of entries is a power of 2 so a key's index is its low bits
+    proofentry_t *entries;
+    uint64_t mask;
+
+    // states searched and the limits which stop the proof once passed
+    uint64_t nodes;
+    uint64_t maxNodes;
+    uint64_t deadline;
+    bool isStopped;
+} proof_t;
+
+
+static void initOrder(proof_t *proof);
+static void searchProof(proof_t   *proof,
+                        char       symbol,
+                        uint32_t   maxProof,
+                        uint32_t   maxDisproof,
+                        numbers_t *numbers,
+                        uint8_t   *bestMove);
+static uint8_t getChildren(proof_t   *proof,
+                           char       symbol,
+                           uint8_t    moves[],
+                           numbers_t  children[]);
+static bool isStopped(proof_t *proof);
+
+static void lookupNumbers(proof_t   *proof,
+                          uint64_t   key,
+                          numbers_t *numbers);
+static void storeNumbers(proof_t         *proof,
+                         uint64_t         key,
+                         const numbers_t *numbers);
+static uint64_t getKey(board_t *board,
+                       char     symbol);
+
+static uint32_t addNumbers(uint32_t a,
+                           uint32_t b);
+
+
+/* ------------------------------ START PUBLIC ------------------------------ */
+
+
+/*
+@context
+    * Proves or disproves that `symbolSelf` has a forced win from `board`.
+    * A forced win is a win however the opponent defends - a draw is not.
+
+@parameters
+    * board
+        * Current state of the Noughts and Crosses game (not ended).
+        * Unchanged once returned (moves are made and unmade).
+    * symbolSelf
+        * Symbol to move next and to prove a win for.
+    * limits
+        * Most states and time to search (`0` for no limit).
+        * Depth is not limited - every state is proved to the end of its game.
+    * memory
+        * Most bytes of the table of proof and disproof numbers.
+    * move
+        * Set to a move which keeps the forced win when proved.
+
+@return
+    * `PROOF_WIN` if proved, `PROOF_NO_WIN` if disproved and `PROOF_UNKNOWN`
+      if a limit was passed first.
+*/
+uint8_t proveWin(board_t        *board,
+                 char            symbolSelf,
+                 const limits_t *limits,
+                 size_t          memory,
+                 uint8_t        *move)
+{
+    proof_t proof;
+    numbers_t numbers;
+    uint64_t count;
+
+    assert(!isWin(board, NOUGHT) && !isWin(board, CROSS) && !isFull(board));
+
+    // largest power of 2 entries fitting within `memory` (at least 1)
+    count = 1;
+    while (count <= memory / sizeof(proofentry_t) / 2)
+    {
+        count *= 2;
+    }
+
+    proof.entries = calloc(count, sizeof(proofentry_t));
+    assert(proof.entries != NULL);
+    proof.mask = count - 1;
+
+    proof.board = board;
+    proof.symbolSelf = symbolSelf;
+    initOrder(&proof);
+
+    proof.nodes = 0;
+    proof.maxNodes = limits->nodes;
+    proof.deadline = 0;
+    if (limits->time > 0)
+    {
+        proof.deadline = getTime() + (limits->time * NS_PER_MS);
+    }
+    proof.isStopped = false;
+
+    // root is not yet proved or disproved
+    numbers.proof = 1;
+    numbers.disproof = 1;
+    searchProof(&proof,
+                symbolSelf,
+                PROOF_INFINITE,
+                PROOF_INFINITE,
+                &numbers,
+                move);
+
+    free(proof.entries);
+
+    if (numbers.proof == 0)
+    {
+        return PROOF_WIN;
+    }
+    else if (numbers.disproof == 0)
+    {
+        return PROOF_NO_WIN;
+    }
+    return PROOF_UNKNOWN;
+}
+
+
+/* ------------------------------- END PUBLIC ------------------------------- */
+/* ----------------------------- START  PRIVATE ----------------------------- */
+
+
+/*
+@context
+    * Orders every cell of the board of `proof` by how many windows contain
+      it - cells within more windows can be part of more wins.
+    * The first of equal children is searched first so this breaks ties.
+
+@parameters
+    * proof
+        * Proof to order the cells of.
+*/
+static void initOrder(proof_t *proof)
+{
+    uint8_t cells, cell, i, j;
+
+    cells = getSize(proof->board) * getSize(proof->board);
+
+    // insertion sort is stable so equal cells keep left to right order
+    for (cell = 0; cell < cells; cell += 1)
+    {
+        for (i = cell;
+             i > 0 && getWindowCount(proof->board, proof->order[i - 1])
+                      < getWindowCount(proof->board, cell);
+             i -= 1);
+
+        for (j = cell; j > i; j -= 1)
+        {
+            proof->order[j] = proof->order[j - 1];
+        }
+        proof->order[i] = cell;
+    }
+}
+
+
+/*
+@context
+    * Searches the state of `proof` until its proof or disproof number
+      reaches its limit (df-pn).
+    * `symbolSelf` states need only 1 move to win (least proof number of a
+      child) but every move disproved (sum of the disproof numbers) and the
+      opponent's states the opposite.
+    * The child with the least work left is searched until it is no longer
+      the least or the sum it is part of reaches its limit.
+
+@parameters
+    * proof
+        * Proof the state is within.
+    * symbol
+        * Symbol to move next.
+    * maxProof
+        * Proof number to search the state until.
+    * maxDisproof
+        * Disproof number to search the state until.
+    * numbers
+        * Set to the proof and disproof numbers of the state.
+        * Unchanged if the proof stopped before the state was searched.
+    * bestMove
+        * Set to the child with the least work left (proved if the state is).
+*/
+static void searchProof(proof_t   *proof,
+                        char       symbol,
+                        uint32_t   maxProof,
+                        uint32_t   maxDisproof,
+                        numbers_t *numbers,
+                        uint8_t   *bestMove)
+{
+    uint8_t moves[BOARD_MAX_SIZE * BOARD_MAX_SIZE];
+    numbers_t children[BOARD_MAX_SIZE * BOARD_MAX_SIZE];
+    uint32_t phi, delta, maxPhi, maxDelta, second, value, childPhi;
+    uint64_t key, limit;
+    uint8_t count, i, best, move;
+    bool isSelf;
+    char symbolOther;
+
+    if (isStopped(proof))
+    {
+        return;
+    }
+
+    symbolOther = symbol == NOUGHT ? CROSS : NOUGHT;
+    isSelf = symbol == proof->symbolSelf;
+    key = getKey(proof->board, symbol);
+
+    // every state is scored by its symbol to move - `phi` is the number it
+    // minimises between its children and `delta` the number it sums
+    maxPhi = isSelf ? maxProof : maxDisproof;
+    maxDelta = isSelf ? maxDisproof : maxProof;
+
+    count = getChildren(proof, symbol, moves, children);
+    while (true)
+    {
+        phi = PROOF_INFINITE;
+        second = PROOF_INFINITE;
+        delta = 0;
+        best = 0;
+        for (i = 0; i < count; i += 1)
+        {
+            value = isSelf ? children[i].proof : children[i].disproof;
+            if (value < phi)
+            {
+                second = phi;
+                phi = value;
+                best = i;
+            }
+            else if (value < second)
+            {
+                second = value;
+            }
+
+            delta = addNumbers(delta,
+                               isSelf ? children[i].disproof
+                                      : children[i].proof);
+        }
+
+        numbers->proof = isSelf ? phi : delta;
+        numbers->disproof = isSelf ? delta : phi;
+        storeNumbers(proof, key, numbers);
+        *bestMove = moves[best];
+
+        if (phi >= maxPhi || delta >= maxDelta || proof->isStopped)
+        {
+            break;
+        }
+
+        // child stops once the second best is better or its sum is reached
+        childPhi = isSelf ? children[best].disproof : children[best].proof;
+        limit = (uint64_t)maxDelta - delta + childPhi;
+        limit = limit > PROOF_INFINITE ? PROOF_INFINITE : limit;
+        value = second < maxPhi - 1 ? second + 1 : maxPhi;
+
+        // children are the opponent's so their numbers swap roles
+        makeMove(proof->board, moves[best], symbol);
+        searchProof(proof,
+                    symbolOther,
+                    isSelf ? value : limit,
+                    isSelf ? limit : value,
+                    &children[best],
+                    &move);
+        unmakeMove(proof->board);
+    }
+}
+
+
+/*
+@context
+    * Gets every move of `symbol` and the numbers of the state it leads to.
+    * A move which ends the game, or lets the opponent win with its next
+      move, is proved or disproved at once - every other has its stored
+      numbers (`1` each if not stored).
+
+@parameters
+    * proof
+        * Proof the state is within.
+    * symbol
+        * Symbol to move next.
+    * moves
+        * Filled with the cell of every move.
+    * children
+        * Filled with the numbers of the state after each of `moves`.
+
+@return
+    * Number of `moves`.
+*/
+static uint8_t getChildren(proof_t   *proof,
+                           char       symbol,
+                           uint8_t    moves[],
+                           numbers_t  children[])
+{
+    board_t *board;
+    uint8_t cells, count, i, cell;
+    bool isProved;
+    char symbolOther;
+
+    board = proof->board;
+    cells = getSize(board) * getSize(board);
+    symbolOther = symbol == NOUGHT ? CROSS : NOUGHT;
+
+    count = 0;
+    for (i = 0; i < cells; i += 1)
+    {
+        cell = proof->order[i];
+        if (!isValidMove(board, cell, symbol))
+        {
+            continue;
+        }
+
+        makeMove(board, cell, symbol);
+        if (isWin(board, symbol) || isFull(board))
+        {
+            // a draw is never a `symbolSelf` win
+            isProved = isWin(board, symbol) && symbol == proof->symbolSelf;
+            children[count].proof = isProved ? 0 : PROOF_INFINITE;
+            children[count].disproof = isProved ? PROOF_INFINITE : 0;
+        }
+        else if (isWinNext(board, symbolOther))
+        {
+            // the opponent wins with its next move (the move did not block)
+            isProved = symbolOther == proof->symbolSelf;
+            children[count].proof = isProved ? 0 : PROOF_INFINITE;
+            children[count].disproof = isProved ? PROOF_INFINITE : 0;
+        }
+        else
+        {
+            lookupNumbers(proof, getKey(board, symbolOther), &children[count]);
+        }
+        unmakeMove(board);
+
+        moves[count] = cell;
+        count += 1;
+    }
+
+    return count;
+}
+
+
+/*
+@context
+    * Counts a state searched and determines if `proof` has passed a limit.
+    * The time is only checked every `NODES_PER_CHECK` states.
+
+@parameters
+    * proof
+        * Proof to count a state of.
+
+@return
+    * Indicates if `proof` is stopped.
+*/
+static bool isStopped(proof_t *proof)
+{
+    proof->nodes += 1;
+
+    if (proof->maxNodes > 0 && proof->nodes > proof->maxNodes)
+    {
+        proof->isStopped = true;
+    }
+    else if (proof->deadline > 0 && proof->nodes % NODES_PER_CHECK == 0
+             && getTime() >= proof->deadline)
+    {
+        proof->isStopped = true;
+    }
+
+    return proof->isStopped;
+}
+
+
+/*
+@context
+    * Gets the stored numbers of the state identified by `key`.
+
+@parameters
+    * proof
+        * Proof to search the table of.
+    * key
+        * Key of the state.
+    * numbers
+        * Set to the stored numbers - `1` each if not stored.
+*/
+static void lookupNumbers(proof_t   *proof,
+                          uint64_t   key,
+                          numbers_t *numbers)
+{
+    const proofentry_t *entry;
+
+    entry = &proof->entries[key & proof->mask];
+    if (entry->key == key
+        && (entry->numbers.proof != 0 || entry->numbers.disproof != 0))
+    {
+        *numbers = entry->numbers;
+        return;
+    }
+
+    numbers->proof = 1;
+    numbers->disproof = 1;
+}
+
+
+/*
+@context
+    * Stores the numbers of the state identified by `key`.
+    * Replaces whichever state was stored at its index.
+
+@parameters
+    * proof
+        * Proof to store within the table of.
+    * key
+        * Key of the state.
+    * numbers
+        * Numbers of the state.
+*/
+static void storeNumbers(proof_t         *proof,
+                         uint64_t         key,
+                         const numbers_t *numbers)
+{
+    proofentry_t *entry;
+
+    entry = &proof->entries[key & proof->mask];
+    entry->key = key;
+    entry->numbers = *numbers;
+}
+
+
+/*
+@context
+    * Gets the key of `board` within the table of numbers.
+
+@parameters
+    * board
+        * Current state of the Noughts and Crosses game.
+    * symbol
+        * Symbol to move next.
+
+@return
+    * Key of `board`.
+*/
+static uint64_t getKey(board_t *board,
+                       char     symbol)
+{
+    if (symbol == CROSS)
+    {
+        return getHash(board) ^ KEY_CROSS;
+    }
+    return getHash(board);
+}
+
+
+/*
+@context
+    * Adds 2 proof or disproof numbers.
+    * Sums stop below `PROOF_INFINITE` unless either number is infinite, so
+      only a proved or disproved state is ever infinite.
+
+@parameters
+    * a
+        * First number.
+    * b
+        * Second number.
+
+@return
+    * Sum of `a` and `b`.
+*/
+static uint32_t addNumbers(uint32_t a,
+                           uint32_t b)
+{
+    if (a == PROOF_INFINITE || b == PROOF_INFINITE)
+    {
+        return PROOF_INFINITE;
+    }
+    else if (a >= PROOF_INFINITE - 1 - b)
+    {
+        return PROOF_INFINITE - 1;
+    }
+    return a + b;
+}
+
+
+/* ------------------------------ END  PRIVATE ------------------------------ */
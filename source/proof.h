@@ -0,0 +1,40 @@
+/*
+@context
+    * Provides a solver which proves or disproves that a symbol has a forced
+      win from a state - a faster tactical check than a full search.
+    * Uses depth-first proof-number search (df-pn).
+        * Each state has a proof number (least states still to prove to show
+          the win) and a disproof number (least to show there is no win).
+        * The state with the least work left is always expanded next, so
+          forced wins are found without searching every defence equally.
+        * Proof and disproof numbers are kept in a table of fixed memory -
+          states replaced by another are found again when next searched.
+    * Proves by the rules of the board (size and win length) so works with
+      every board the minimax search does.
+    * Draws are not wins so are disproofs.
+*/
+
+
+#ifndef _PROOF_H
+    #define _PROOF_H
+
+    #include <stddef.h>
+    #include <stdint.h>
+
+    #include "board.h"
+    #include "minimax.h"
+
+
+    // result of trying to prove a forced win
+    static const uint8_t PROOF_WIN = 0;      // forced win proved
+    static const uint8_t PROOF_NO_WIN = 1;   // no forced win (disproved)
+    static const uint8_t PROOF_UNKNOWN = 2;  // a limit was passed first
+
+
+    uint8_t proveWin(board_t        *board,
+                     char            symbolSelf,
+                     const limits_t *limits,
+                     size_t          memory,
+                     uint8_t        *move);
+
+#endif
@@ -0,0 +1,626 @@
+/*
+@context
+    * Replays recorded positions through the engine without the interface
+      and checks its decisions against a stored baseline.
+    * Positions are read from a position file (see `position.h`) - a list of
+      positions or every position of recorded games in turn.
+        * `./replay record FILE SIZE LENGTH GAMES [DEPTH]` - records games of
+          the engine against itself (game `i` opened in cell `i`) with every
+          position the engine decides a move of.
+        * `./replay save FILE BASELINE [DEPTH]` - decides the move of every
+          position of `FILE` (`getBestMove`, or to `DEPTH` if given) and
+          writes the move, score, states searched and time of each.
+        * `./replay check FILE BASELINE` - decides every position again and
+          prints each whose move or score differs from `BASELINE`, then a
+          line of JSON of the states searched and time against `BASELINE`.
+    * `check` fails if any move or score has changed - a lost game the
+      engine once drew (or a win it once found) is a changed score.
+        * Save the baseline again after a change which is meant to alter
+          moves (equal moves may be chosen differently).
+    * Built with `make replay` - with the opening book (as the program) and
+      `SEARCH_STATS` so states searched can be counted.
+    * Positions share 1 transposition table and are searched by 1 thread in
+      file order (as a game) so results can be compared between versions.
+*/
+
+
+#include <assert.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "board.h"
+#include "minimax.h"
+#include "position.h"
+#include "stats.h"
+#include "timer.h"
+
+
+// entries of the transposition table shared by every position
+static const uint32_t TABLE_SIZE = 1 << 20;
+
+static const double NS_PER_S = 1e9;
+
+// decisions allocated before any more are needed (doubled once full)
+static const uint32_t FIRST_CAPACITY = 256;
+
+
+// decision of a position and the cost of finding it
+typedef struct
+{
+    uint8_t move;
+    score_t score;
+    uint64_t nodes;
+    uint64_t time;
+} decision_t;
+
+
+static int recordGames(const char *path,
+                       uint8_t     size,
+                       uint8_t     length,
+                       uint32_t    games,
+                       uint8_t     depth);
+static int saveBaseline(const char *path,
+                        const char *baselinePath,
+                        uint8_t     depth);
+static int checkBaseline(const char *path,
+                         const char *baselinePath);
+
+static decision_t *replayPositions(const char *path,
+                                   uint8_t     depth,
+                                   uint32_t   *count);
+static decision_t *readBaseline(const char *baselinePath,
+                                uint8_t    *depth,
+                                uint32_t   *count);
+static uint8_t decideMove(board_t *board,
+                          char     symbol,
+                          uint8_t  depth,
+                          score_t *score);
+static bool isEnded(board_t *board);
+static double getChange(uint64_t value,
+                        uint64_t baseline);
+
+
+/* ------------------------------ START PUBLIC ------------------------------ */
+
+
+/*
+@context
+    * Entry point of program.
+    * Runs the mode named by the first argument.
+
+@parameters
+    * argc
+        * Number of arguments.
+    * argv
+        * Name of the program, the mode then the arguments of the mode.
+
+@return
+    * Indicates program successfully terminates.
+    * Fails if the arguments are invalid, a file cannot be used or (`check`)
+      a decision has changed.
+*/
+int main(int   argc,
+         char *argv[])
+{
+    if (argc >= 6 && argc <= 7 && strcmp(argv[1], "record") == 0)
+    {
+        return recordGames(argv[2],
+                           atoi(argv[3]),
+                           atoi(argv[4]),
+                           strtoul(argv[5], NULL, 10),
+                           argc == 7 ? atoi(argv[6]) : 0);
+    }
+    if (argc >= 4 && argc <= 5 && strcmp(argv[1], "save") == 0)
+    {
+        return saveBaseline(argv[2], argv[3], argc == 5 ? atoi(argv[4]) : 0);
+    }
+    if (argc == 4 && strcmp(argv[1], "check") == 0)
+    {
+        return checkBaseline(argv[2], argv[3]);
+    }
+
+    fprintf(stderr,
+            "usage: %s record FILE SIZE LENGTH GAMES [DEPTH]\n"
+            "       %s save FILE BASELINE [DEPTH]\n"
+            "       %s check FILE BASELINE\n",
+            argv[0], argv[0], argv[0]);
+    return EXIT_FAILURE;
+}
+
+
+/* ------------------------------- END PUBLIC ------------------------------- */
+/* ----------------------------- START  PRIVATE ----------------------------- */
+
+
+/*
+@context
+    * Records games of the engine against itself to a position file.
+    * Each game is opened by noughts in a different cell (game `i` in cell
+      `i`, repeating once every cell has opened) so every game differs.
+
+@parameters
+    * path
+        * Position file to write.
+    * size
+        * Number of rows and columns of each board.
+    * length
+        * Number of symbols in a row to win.
+    * games
+        * Number of games to record.
+    * depth
+        * Depth of each search (`0` searches to the end of every game).
+
+@return
+    * Indicates if the games were recorded.
+*/
+static int recordGames(const char *path,
+                       uint8_t     size,
+                       uint8_t     length,
+                       uint32_t    games,
+                       uint8_t     depth)
+{
+    FILE *file;
+    boardstorage_t storage;
+    board_t *board;
+    position_t position;
+    uint32_t game, count;
+    score_t score;
+    char symbol;
+    bool isWritten;
+
+    if (size < 1 || size > BOARD_MAX_SIZE || length < 1 || length > size)
+    {
+        fprintf(stderr, "invalid board: %ux%u (in a row %u)\n",
+                size, size, length);
+        return EXIT_FAILURE;
+    }
+
+    file = fopen(path, "wb");
+    if (file == NULL)
+    {
+        fprintf(stderr, "cannot write: %s\n", path);
+        return EXIT_FAILURE;
+    }
+
+    initMinimax(TABLE_SIZE);
+    board = initBoardStorage(&storage, size, length);
+
+    isWritten = writePositionHeader(file);
+    count = 0;
+    for (game = 0; game < games && isWritten; game += 1)
+    {
+        resetBoard(board);
+        setCell(board, game % (size * size), NOUGHT);
+        symbol = CROSS;
+
+        while (!isEnded(board) && isWritten)
+        {
+            encodePosition(board, symbol, &position);
+            isWritten = writePosition(file, &position);
+            count += 1;
+
+            setCell(board, decideMove(board, symbol, depth, &score), symbol);
+            symbol = symbol == NOUGHT ? CROSS : NOUGHT;
+        }
+    }
+
+    freeMinimax();
+    isWritten = fclose(file) == 0 && isWritten;
+
+    if (!isWritten)
+    {
+        fprintf(stderr, "cannot write: %s\n", path);
+        return EXIT_FAILURE;
+    }
+
+    printf("recorded %u games (%u positions)\n", games, count);
+    return EXIT_SUCCESS;
+}
+
+
+/*
+@context
+    * Decides every position of a position file and writes the baseline of
+      them.
+    * A baseline is the depth of its searches then 1 line for each position
+      of its move, score, states searched and nanoseconds taken.
+
+@parameters
+    * path
+        * Position file to replay.
+    * baselinePath
+        * Baseline to write.
+    * depth
+        * Depth of each search (`0` searches to the end of every game).
+
+@return
+    * Indicates if the baseline was written.
+*/
+static int saveBaseline(const char *path,
+                        const char *baselinePath,
+                        uint8_t     depth)
+{
+    FILE *file;
+    decision_t *decisions;
+    uint32_t count, i;
+    bool isWritten;
+
+    decisions = replayPositions(path, depth, &count);
+    if (decisions == NULL)
+    {
+        return EXIT_FAILURE;
+    }
+
+    file = fopen(baselinePath, "w");
+    isWritten = file != NULL && fprintf(file, "depth %u\n", depth) > 0;
+    for (i = 0; i < count && isWritten; i += 1)
+    {
+        isWritten = fprintf(file, "%u %" PRId32 " %" PRIu64 " %" PRIu64 "\n",
+                            decisions[i].move,
+                            decisions[i].score,
+                            decisions[i].nodes,
+                            decisions[i].time) > 0;
+    }
+    if (file != NULL)
+    {
+        isWritten = fclose(file) == 0 && isWritten;
+    }
+
+    free(decisions);
+
+    if (!isWritten)
+    {
+        fprintf(stderr, "cannot write: %s\n", baselinePath);
+        return EXIT_FAILURE;
+    }
+
+    printf("saved %u positions\n", count);
+    return EXIT_SUCCESS;
+}
+
+
+/*
+@context
+    * Decides every position of a position file again and compares each with
+      a baseline.
+    * Prints every position whose move or score differs, then the totals of
+      states searched and time against the baseline.
+
+@parameters
+    * path
+        * Position file to replay.
+    * baselinePath
+        * Baseline saved from the same position file.
+
+@return
+    * Indicates if every move and score is unchanged.
+*/
+static int checkBaseline(const char *path,
+                         const char *baselinePath)
+{
+    decision_t *decisions, *baseline;
+    uint64_t nodes, baselineNodes, time, baselineTime;
+    uint32_t count, baselineCount, moves, scores, i;
+    uint8_t depth;
+
+    baseline = readBaseline(baselinePath, &depth, &baselineCount);
+    if (baseline == NULL)
+    {
+        return EXIT_FAILURE;
+    }
+
+    decisions = replayPositions(path, depth, &count);
+    if (decisions == NULL)
+    {
+        free(baseline);
+        return EXIT_FAILURE;
+    }
+
+    if (count != baselineCount)
+    {
+        fprintf(stderr, "%s has %u positions but %s has %u\n",
+                path, count, baselinePath, baselineCount);
+        free(decisions);
+        free(baseline);
+        return EXIT_FAILURE;
+    }
+
+    moves = 0;
+    scores = 0;
+    nodes = 0;
+    baselineNodes = 0;
+    time = 0;
+    baselineTime = 0;
+    for (i = 0; i < count; i += 1)
+    {
+        if (decisions[i].move != baseline[i].move
+            || decisions[i].score != baseline[i].score)
+        {
+            printf("position %u: move %u score %" PRId32
+                   " (baseline move %u score %" PRId32 ")\n",
+                   i, decisions[i].move, decisions[i].score,
+                   baseline[i].move, baseline[i].score);
+        }
+        moves += decisions[i].move != baseline[i].move;
+        scores += decisions[i].score != baseline[i].score;
+
+        nodes += decisions[i].nodes;
+        baselineNodes += baseline[i].nodes;
+        time += decisions[i].time;
+        baselineTime += baseline[i].time;
+    }
+
+    printf("{\"positions\": %u, \"moves_changed\": %u, "
+           "\"scores_changed\": %u, \"nodes\": %" PRIu64 ", "
+           "\"baseline_nodes\": %" PRIu64 ", \"nodes_change\": %.1f, "
+           "\"seconds\": %.6f, \"baseline_seconds\": %.6f, "
+           "\"time_change\": %.1f}\n",
+           count, moves, scores, nodes, baselineNodes,
+           getChange(nodes, baselineNodes),
+           time / NS_PER_S, baselineTime / NS_PER_S,
+           getChange(time, baselineTime));
+
+    free(decisions);
+    free(baseline);
+
+    return moves == 0 && scores == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+/*
+@context
+    * Decides the move of every position of a position file in turn.
+
+@parameters
+    * path
+        * Position file to replay.
+    * depth
+        * Depth of each search (`0` searches to the end of every game).
+    * count
+        * Set to the number of positions.
+
+@return
+    * Decision of each position in file order (freed by the caller).
+    * `NULL` if the file cannot be read or a position has ended.
+*/
+static decision_t *replayPositions(const char *path,
+                                   uint8_t     depth,
+                                   uint32_t   *count)
+{
+    FILE *file;
+    decision_t *decisions;
+    boardstorage_t storage;
+    board_t *board;
+    position_t position;
+    stats_t stats;
+    uint32_t capacity;
+    uint64_t start;
+    bool isReplayed;
+
+    file = fopen(path, "rb");
+    if (file == NULL || !readPositionHeader(file))
+    {
+        fprintf(stderr, "cannot read position file: %s\n", path);
+        if (file != NULL)
+        {
+            fclose(file);
+        }
+        return NULL;
+    }
+
+    capacity = FIRST_CAPACITY;
+    decisions = malloc(sizeof(decision_t) * capacity);
+    assert(decisions != NULL);
+
+    initMinimax(TABLE_SIZE);
+    setStats(&stats);
+    board = NULL;
+
+    *count = 0;
+    isReplayed = true;
+    while (isReplayed && readPosition(file, &position))
+    {
+        if (*count == capacity)
+        {
+            capacity *= 2;
+            decisions = realloc(decisions, sizeof(decision_t) * capacity);
+            assert(decisions != NULL);
+        }
+
+        if (board == NULL || getSize(board) != position.size
+            || getLength(board) != position.length)
+        {
+            board = initBoardStorage(&storage, position.size, position.length);
+        }
+        decodePosition(&position, board);
+
+        isReplayed = !isEnded(board);
+        if (isReplayed)
+        {
+            clearStats(&stats);
+            start = getTime();
+            decisions[*count].move = decideMove(board,
+                                                position.symbol,
+                                                depth,
+                                                &decisions[*count].score);
+            decisions[*count].time = getTime() - start;
+            decisions[*count].nodes = getTotalNodes(&stats);
+            *count += 1;
+        }
+    }
+
+    setStats(NULL);
+    freeMinimax();
+
+    // positions end at the end of the file (not an error or ended position)
+    isReplayed = isReplayed && feof(file) && !ferror(file);
+    fclose(file);
+
+    if (!isReplayed)
+    {
+        fprintf(stderr, "cannot replay position %u of %s\n", *count, path);
+        free(decisions);
+        return NULL;
+    }
+
+    return decisions;
+}
+
+
+/*
+@context
+    * Reads a baseline written by `saveBaseline`.
+
+@parameters
+    * baselinePath
+        * Baseline to read.
+    * depth
+        * Set to the depth of its searches.
+    * count
+        * Set to the number of positions.
+
+@return
+    * Decision of each position in file order (freed by the caller).
+    * `NULL` if the baseline cannot be read.
+*/
+static decision_t *readBaseline(const char *baselinePath,
+                                uint8_t    *depth,
+                                uint32_t   *count)
+{
+    FILE *file;
+    decision_t *decisions;
+    decision_t decision;
+    uint32_t capacity;
+    unsigned move, searchDepth;
+    bool isRead;
+
+    file = fopen(baselinePath, "r");
+    if (file == NULL || fscanf(file, "depth %u", &searchDepth) != 1)
+    {
+        fprintf(stderr, "cannot read baseline: %s\n", baselinePath);
+        if (file != NULL)
+        {
+            fclose(file);
+        }
+        return NULL;
+    }
+    *depth = searchDepth;
+
+    capacity = FIRST_CAPACITY;
+    decisions = malloc(sizeof(decision_t) * capacity);
+    assert(decisions != NULL);
+
+    *count = 0;
+    while (fscanf(file, "%u %" SCNd32 " %" SCNu64 " %" SCNu64,
+                  &move, &decision.score, &decision.nodes,
+                  &decision.time) == 4)
+    {
+        if (*count == capacity)
+        {
+            capacity *= 2;
+            decisions = realloc(decisions, sizeof(decision_t) * capacity);
+            assert(decisions != NULL);
+        }
+
+        decision.move = move;
+        decisions[*count] = decision;
+        *count += 1;
+    }
+    isRead = feof(file) && !ferror(file);
+    fclose(file);
+
+    if (!isRead)
+    {
+        fprintf(stderr, "cannot read baseline: %s\n", baselinePath);
+        free(decisions);
+        return NULL;
+    }
+
+    return decisions;
+}
+
+
+/*
+@context
+    * Decides the move of `symbol` within `board` as the engine does.
+
+@parameters
+    * board
+        * Current state of the Noughts and Crosses game (not ended).
+    * symbol
+        * Symbol to move next.
+    * depth
+        * Depth of the search (`0` searches to the end of every game).
+    * score
+        * Set to the score of the move.
+
+@return
+    * Cell of the move.
+*/
+static uint8_t decideMove(board_t *board,
+                          char     symbol,
+                          uint8_t  depth,
+                          score_t *score)
+{
+    limits_t limits;
+
+    if (depth == 0)
+    {
+        return getBestMoveScore(board, symbol, score);
+    }
+
+    limits.nodes = 0;
+    limits.time = 0;
+    limits.depth = depth;
+
+    return getBestMoveLimited(board, symbol, &limits, score);
+}
+
+
+/*
+@context
+    * Determines if the game of `board` has ended.
+
+@parameters
+    * board
+        * Board to check.
+
+@return
+    * Whether a symbol has won or every cell is filled.
+*/
+static bool isEnded(board_t *board)
+{
+    return isWin(board, NOUGHT) || isWin(board, CROSS) || isFull(board);
+}
+
+
+/*
+@context
+    * Gets the percentage change of `value` from `baseline`.
+
+@parameters
+    * value
+        * Value now.
+    * baseline
+        * Value of the baseline.
+
+@return
+    * Percentage change (`0` if `baseline` is `0`).
+*/
+static double getChange(uint64_t value,
+                        uint64_t baseline)
+{
+    if (baseline == 0)
+    {
+        return 0;
+    }
+
+    return (((double)value / baseline) - 1) * 100;
+}
+
+
+/* ------------------------------ END  PRIVATE ------------------------------ */
@@ -0,0 +1,977 @@
+// `mmap` and file descriptors are POSIX so are hidden by strict C17 without
+// this
+#define _POSIX_C_SOURCE 200809L
+
+#include "retrograde.h"
+
+#include <assert.h>
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <threads.h>
+#include <unistd.h>
+
+#include "bitboard.h"
+#include "lines.h"
+
+
+// each state is a byte of its result (top 2 bits) and moves until the game
+// ends (the rest) - unreachable states are `0`
+static const uint8_t RESULT_SHIFT = 6;
+static const uint8_t DISTANCE_MASK = (1 << 6) - 1;
+
+static const uint8_t RESULT_NONE = 0;
+static const uint8_t RESULT_LOSS = 1;
+static const uint8_t RESULT_DRAW = 2;
+static const uint8_t RESULT_WIN = 3;
+
+// low digits of every index within a block - blocks are the indexes sharing
+// the rest of their digits (`3^10` states solved by a thread at once)
+static const uint8_t BLOCK_DIGITS = 10;
+
+// start of every database file and a value whose bytes differ in every byte
+// order (files are only loaded by machines of the same byte order)
+static const char FILE_MAGIC[8] = {'N', 'C', 'R', 'E', 'T', 'R', 'O', '\0'};
+static const uint32_t FILE_BYTE_ORDER = 0x01020304;
+
+// header is padded so the states after it are aligned to cache lines
+#define FILE_HEADER_BYTES 64
+
+
+struct retrograde_s
+{
+    uint8_t size;
+    uint8_t length;
+    uint8_t cells;
+
+    // result of the state at each index (`3^cells` states)
+    uint64_t count;
+    uint8_t *values;
+
+    // mapping of the file the states are within (`NULL` if allocated)
+    void *map;
+    size_t mapBytes;
+};
+
+// start of a database file - followed by every state in index order
+typedef struct
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint8_t size;
+    uint8_t length;
+    uint8_t reserved[6];
+    uint64_t count;
+} fileheader_t;
+
+static_assert(sizeof(fileheader_t) <= FILE_HEADER_BYTES,
+              "FILE_HEADER_BYTES too small to hold a file header");
+
+// blocks being solved by every thread at once - every block of a group has
+// the same number of symbols within its high digits
+typedef struct
+{
+    retrograde_t *retrograde;
+    uint64_t powers[BOARD_MAX_SIZE * BOARD_MAX_SIZE];
+    uint16_t bits[BOARD_MAX_SIZE * BOARD_MAX_SIZE];
+    uint8_t lowDigits;
+
+    // blocks in the order they are solved and the current group of them
+    uint64_t *blocks;
+    uint64_t last;
+
+    // index within `blocks` of the next block to take
+    atomic_uint_fast64_t next;
+} solve_t;
+
+// thread solving blocks
+typedef struct
+{
+    thrd_t thread;
+    bool isStarted;
+    solve_t *solve;
+} worker_t;
+
+// digits of the index being solved with the bitboard and count of each symbol
+typedef struct
+{
+    uint8_t digits[BOARD_MAX_SIZE * BOARD_MAX_SIZE];
+    bitboard_t stones[2];
+    uint8_t counts[2];
+} state_t;
+
+
+static bool isValidHeader(const fileheader_t *header,
+                          size_t              bytes);
+static uint64_t getPower(uint8_t exponent);
+static bool getIndex(retrograde_t *retrograde,
+                     board_t      *board,
+                     char          symbol,
+                     uint64_t     *index,
+                     uint8_t      *digit);
+static score_t getValueScore(uint8_t value);
+
+static void solveGroups(solve_t *solve,
+                        uint8_t  threads);
+static int runSolve(void *worker);
+static void solveBlock(solve_t  *solve,
+                       uint64_t  block);
+static void setDigit(solve_t *solve,
+                     state_t *state,
+                     uint8_t  cell,
+                     uint8_t  digit);
+static uint8_t solveState(solve_t  *solve,
+                          state_t  *state,
+                          uint64_t  index);
+
+
+/* ------------------------------ START PUBLIC ------------------------------ */
+
+
+/*
+@context
+    * Solves every state of a board by retrograde analysis.
+    * Blocks of states are split between `threads` threads.
+
+@parameters
+    * size
+        * Numbers of rows and columns of the board.
+        * Board must have at most `RETROGRADE_MAX_CELLS` cells.
+    * length
+        * Number of consecutive cells which win (`1` to `size`).
+    * threads
+        * Number of threads to solve with.
+        * `0` and `1` solve without starting a thread.
+
+@return
+    * Database of every state of the board.
+    * `NULL` if the board is too large or `length` is not within the board.
+*/
+retrograde_t *solveRetrograde(uint8_t size,
+                              uint8_t length,
+                              uint8_t threads)
+{
+    retrograde_t *retrograde;
+    solve_t solve;
+    uint64_t *blocks;
+    uint8_t cells, cell;
+
+    if (size == 0 || size > BOARD_MAX_SIZE || length == 0 || length > size
+        || size * size > RETROGRADE_MAX_CELLS)
+    {
+        return NULL;
+    }
+    cells = size * size;
+
+    retrograde = malloc(sizeof(retrograde_t));
+    assert(retrograde != NULL);
+
+    retrograde->size = size;
+    retrograde->length = length;
+    retrograde->cells = cells;
+    retrograde->count = getPower(cells);
+    retrograde->values = calloc(retrograde->count, sizeof(uint8_t));
+    assert(retrograde->values != NULL);
+    retrograde->map = NULL;
+    retrograde->mapBytes = 0;
+
+    // winning lines are found by `hasLine`, which needs its kernel chosen
+    initLines();
+
+    solve.retrograde = retrograde;
+    for (cell = 0; cell < cells; cell += 1)
+    {
+        solve.powers[cell] = getPower(cell);
+        solve.bits[cell] = getBit(cell / size, cell % size);
+    }
+    solve.lowDigits = cells < BLOCK_DIGITS ? cells : BLOCK_DIGITS;
+
+    blocks = malloc(sizeof(uint64_t) * getPower(cells - solve.lowDigits));
+    assert(blocks != NULL);
+
+    solve.blocks = blocks;
+    solveGroups(&solve, threads);
+
+    free(blocks);
+
+    return retrograde;
+}
+
+
+/*
+@context
+    * Loads a database written by `saveRetrograde`.
+    * States are mapped from the file rather than read so only the states
+      looked up are read from disk.
+
+@parameters
+    * path
+        * Path of the file to load.
+
+@return
+    * Database within the file.
+    * `NULL` if the file cannot be read or is not a database of this engine.
+*/
+retrograde_t *loadRetrograde(const char *path)
+{
+    retrograde_t *retrograde;
+    const fileheader_t *header;
+    struct stat status;
+    void *map;
+    int file;
+
+    file = open(path, O_RDONLY);
+    if (file < 0)
+    {
+        return NULL;
+    }
+
+    map = MAP_FAILED;
+    if (fstat(file, &status) == 0 && status.st_size >= FILE_HEADER_BYTES)
+    {
+        map = mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    }
+
+    // the mapping stays valid once the file is closed
+    close(file);
+    if (map == MAP_FAILED)
+    {
+        return NULL;
+    }
+
+    if (!isValidHeader(map, status.st_size))
+    {
+        munmap(map, status.st_size);
+        return NULL;
+    }
+
+    retrograde = malloc(sizeof(retrograde_t));
+    assert(retrograde != NULL);
+
+    header = map;
+    retrograde->size = header->size;
+    retrograde->length = header->length;
+    retrograde->cells = header->size * header->size;
+    retrograde->count = header->count;
+    retrograde->values = (uint8_t *)map + FILE_HEADER_BYTES;
+    retrograde->map = map;
+    retrograde->mapBytes = status.st_size;
+
+    return retrograde;
+}
+
+
+/*
+@context
+    * Writes every state of `retrograde` to a file loaded by `loadRetrograde`.
+    * Written to a temporary file then renamed over `path` so no process
+      loads a partly written file.
+
+@parameters
+    * retrograde
+        * Database to write.
+    * path
+        * Path of the file to write.
+
+@return
+    * Indicates if the whole file was written.
+*/
+bool saveRetrograde(retrograde_t *retrograde,
+                    const char   *path)
+{
+    uint8_t header[FILE_HEADER_BYTES];
+    fileheader_t fields;
+    char *temporary;
+    FILE *file;
+    bool isWritten;
+
+    temporary = malloc(strlen(path) + sizeof(".tmp"));
+    assert(temporary != NULL);
+    strcpy(temporary, path);
+    strcat(temporary, ".tmp");
+
+    memset(&fields, 0, sizeof(fields));
+    memcpy(fields.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+    fields.version = RETROGRADE_FILE_VERSION;
+    fields.byteOrder = FILE_BYTE_ORDER;
+    fields.size = retrograde->size;
+    fields.length = retrograde->length;
+    fields.count = retrograde->count;
+
+    memset(header, 0, sizeof(header));
+    memcpy(header, &fields, sizeof(fields));
+
+    isWritten = false;
+    if ((file = fopen(temporary, "wb")) != NULL)
+    {
+        isWritten = fwrite(header, sizeof(header), 1, file) == 1
+                    && fwrite(retrograde->values,
+                              sizeof(uint8_t),
+                              retrograde->count,
+                              file) == retrograde->count;
+
+        isWritten = fclose(file) == 0 && isWritten;
+        isWritten = isWritten && rename(temporary, path) == 0;
+        if (!isWritten)
+        {
+            remove(temporary);
+        }
+    }
+
+    free(temporary);
+
+    return isWritten;
+}
+
+
+/*
+@context
+    * Frees `retrograde` (and unmaps its file if loaded from one).
+
+@parameters
+    * retrograde
+        * Database to free.
+*/
+void freeRetrograde(retrograde_t *retrograde)
+{
+    if (retrograde->map != NULL)
+    {
+        munmap(retrograde->map, retrograde->mapBytes);
+    }
+    else
+    {
+        free(retrograde->values);
+    }
+    free(retrograde);
+}
+
+
+/*
+@context
+    * Gets the number of rows and columns of the board `retrograde` solved.
+
+@parameters
+    * retrograde
+        * Database to get the board size of.
+
+@return
+    * Size of the board.
+*/
+uint8_t getRetrogradeSize(retrograde_t *retrograde)
+{
+    return retrograde->size;
+}
+
+
+/*
+@context
+    * Gets the number of consecutive cells which win the board `retrograde`
+      solved.
+
+@parameters
+    * retrograde
+        * Database to get the win length of.
+
+@return
+    * Win length of the board.
+*/
+uint8_t getRetrogradeLength(retrograde_t *retrograde)
+{
+    return retrograde->length;
+}
+
+
+/*
+@context
+    * Gets the number of states `retrograde` holds (reachable or not).
+
+@parameters
+    * retrograde
+        * Database to get the number of states of.
+
+@return
+    * `3` to the power of the cells of the board.
+*/
+uint64_t getRetrogradeCount(retrograde_t *retrograde)
+{
+    return retrograde->count;
+}
+
+
+/*
+@context
+    * Gets the score of `board` for `symbol` to move next.
+    * Same as the score of `getBestMoveScore` - states which already ended
+      score their end (`SCORE_LOSE` or `SCORE_DRAW`).
+
+@parameters
+    * retrograde
+        * Database of the board's size and win length.
+    * board
+        * Current state of the Noughts and Crosses game.
+    * symbol
+        * Symbol to move next.
+    * score
+        * Set to the score of `board` for `symbol` if found.
+
+@return
+    * Indicates if `board` is a reachable state of `retrograde` with `symbol`
+      to move.
+*/
+bool getRetrogradeScore(retrograde_t *retrograde,
+                        board_t      *board,
+                        char          symbol,
+                        score_t      *score)
+{
+    uint64_t index;
+    uint8_t digit, value;
+
+    if (!getIndex(retrograde, board, symbol, &index, &digit))
+    {
+        return false;
+    }
+
+    value = retrograde->values[index];
+    if (value >> RESULT_SHIFT == RESULT_NONE)
+    {
+        return false;
+    }
+
+    *score = getValueScore(value);
+    return true;
+}
+
+
+/*
+@context
+    * Looks up the optimal move of `symbolSelf` in current `board` state.
+    * Moves are the first cell whose state has the result and distance
+      `board` was solved with.
+    * Only found if `board` is a reachable state of `retrograde` which has not
+      ended.
+
+@parameters
+    * retrograde
+        * Database of the board's size and win length.
+    * board
+        * Current state of the Noughts and Crosses game.
+    * symbolSelf
+        * Symbol to find best move for.
+    * move
+        * Set to the cell of the optimal move if found.
+    * score
+        * Set to the score of the optimal move if found.
+
+@return
+    * Indicates if the optimal move was found.
+*/
+bool lookupRetrograde(retrograde_t *retrograde,
+                      board_t      *board,
+                      char          symbolSelf,
+                      uint8_t      *move,
+                      score_t      *score)
+{
+    uint64_t index;
+    uint8_t digit, value, result, distance, child, cell;
+
+    if (!getIndex(retrograde, board, symbolSelf, &index, &digit)
+        || isFull(board))
+    {
+        return false;
+    }
+
+    value = retrograde->values[index];
+    result = value >> RESULT_SHIFT;
+    distance = value & DISTANCE_MASK;
+
+    // ended by a win (the only loss 0 moves away) or never reached
+    if (result == RESULT_NONE || (result == RESULT_LOSS && distance == 0))
+    {
+        return false;
+    }
+
+    // state after the move is for the other symbol so has the opposite
+    // result 1 move closer to the end
+    child = value;
+    if (result != RESULT_DRAW)
+    {
+        child = ((RESULT_WIN + RESULT_LOSS - result) << RESULT_SHIFT)
+                | (distance - 1);
+    }
+
+    for (cell = 0; cell < retrograde->cells; cell += 1)
+    {
+        if (getCell(board, cell) == EMPTY
+            && retrograde->values[index + (digit * getPower(cell))] == child)
+        {
+            *move = cell;
+            *score = getValueScore(value);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/* ------------------------------- END PUBLIC ------------------------------- */
+/* ----------------------------- START  PRIVATE ----------------------------- */
+
+
+/*
+@context
+    * Determines if a file starts with the header of a database of this
+      engine (built for the same byte order) and holds all of its states.
+
+@parameters
+    * header
+        * Start of the file.
+    * bytes
+        * Size of the file in bytes.
+
+@return
+    * Indicates if the file is a whole database of this engine.
+*/
+static bool isValidHeader(const fileheader_t *header,
+                          size_t              bytes)
+{
+    return memcmp(header->magic, FILE_MAGIC, sizeof(FILE_MAGIC)) == 0
+           && header->version == RETROGRADE_FILE_VERSION
+           && header->byteOrder == FILE_BYTE_ORDER
+           && header->size > 0
+           && header->size * header->size <= RETROGRADE_MAX_CELLS
+           && header->length > 0
+           && header->length <= header->size
+           && header->count == getPower(header->size * header->size)
+           && bytes == FILE_HEADER_BYTES + header->count;
+}
+
+
+/*
+@context
+    * Gets `3` to the power of `exponent`.
+
+@parameters
+    * exponent
+        * Power to raise `3` to (at most `POSITION_INDEX_MAX_CELLS`).
+
+@return
+    * `3^exponent`.
+*/
+static uint64_t getPower(uint8_t exponent)
+{
+    uint64_t power;
+
+    power = 1;
+    while (exponent > 0)
+    {
+        power *= 3;
+        exponent -= 1;
+    }
+
+    return power;
+}
+
+
+/*
+@context
+    * Gets the index of `board` within `retrograde` for `symbol` to move.
+    * Noughts move first within the database so `symbol` is a nought if it
+      has as many symbols as the other, otherwise a cross.
+
+@parameters
+    * retrograde
+        * Database to get the index within.
+    * board
+        * Board to get the index of.
+    * symbol
+        * Symbol to move next.
+    * index
+        * Set to the index of `board`.
+    * digit
+        * Set to the digit of `symbol` within the index (`1` or `2`).
+
+@return
+    * Indicates if `board` is of the board `retrograde` solved and `symbol`
+      can move next.
+*/
+static bool getIndex(retrograde_t *retrograde,
+                     board_t      *board,
+                     char          symbol,
+                     uint64_t     *index,
+                     uint8_t      *digit)
+{
+    int8_t balance, cell;
+    char found;
+
+    if (getSize(board) != retrograde->size
+        || getLength(board) != retrograde->length)
+    {
+        return false;
+    }
+
+    balance = 0;
+    for (cell = 0; cell < retrograde->cells; cell += 1)
+    {
+        found = getCell(board, cell);
+        balance += found == symbol;
+        balance -= found != symbol && found != EMPTY;
+    }
+
+    // symbol moving first has as many symbols as the other when to move
+    if (balance != 0 && balance != -1)
+    {
+        return false;
+    }
+    *digit = balance == 0 ? 1 : 2;
+
+    *index = 0;
+    for (cell = retrograde->cells - 1; cell >= 0; cell -= 1)
+    {
+        found = getCell(board, cell);
+        *index *= 3;
+        if (found == symbol)
+        {
+            *index += *digit;
+        }
+        else if (found != EMPTY)
+        {
+            *index += 3 - *digit;
+        }
+    }
+
+    return true;
+}
+
+
+/*
+@context
+    * Gets the score of a solved state for the symbol to move.
+
+@parameters
+    * value
+        * Result and distance of the state.
+
+@return
+    * Score of the state (see `score.h`).
+*/
+static score_t getValueScore(uint8_t value)
+{
+    uint8_t result, distance;
+
+    result = value >> RESULT_SHIFT;
+    distance = value & DISTANCE_MASK;
+
+    if (result == RESULT_WIN)
+    {
+        return SCORE_WIN - distance;
+    }
+    if (result == RESULT_LOSS)
+    {
+        return SCORE_LOSE + distance;
+    }
+    return SCORE_DRAW;
+}
+
+
+/*
+@context
+    * Solves every block of states in groups by their high digits.
+        * A move within the low digits leads to a higher index of the same
+          block - solved first as each block is solved from its highest
+          index down.
+        * A move within the high digits leads to a block with 1 more symbol
+          within its high digits - solved by an earlier group.
+    * Blocks of a group are split between threads which are joined before the
+      next group starts.
+
+@parameters
+    * solve
+        * Solve with `blocks` to fill with the order blocks are solved in.
+    * threads
+        * Number of threads to solve each group with.
+*/
+static void solveGroups(solve_t *solve,
+                        uint8_t  threads)
+{
+    worker_t *workers;
+    worker_t worker;
+    uint64_t *blocks, count, first, block, rest;
+    uint8_t highDigits, symbols, filled, i;
+
+    blocks = solve->blocks;
+    highDigits = solve->retrograde->cells - solve->lowDigits;
+    count = getPower(highDigits);
+
+    workers = NULL;
+    if (threads > 1)
+    {
+        workers = malloc(sizeof(worker_t) * threads);
+        assert(workers != NULL);
+    }
+    worker.solve = solve;
+
+    first = 0;
+    for (symbols = highDigits + 1; symbols > 0; symbols -= 1)
+    {
+        // blocks with `symbols - 1` symbols within their high digits
+        solve->last = first;
+        for (block = 0; block < count; block += 1)
+        {
+            filled = 0;
+            for (rest = block; rest > 0; rest /= 3)
+            {
+                filled += rest % 3 != 0;
+            }
+            if (filled == symbols - 1)
+            {
+                blocks[solve->last] = block;
+                solve->last += 1;
+            }
+        }
+        atomic_init(&solve->next, first);
+
+        // blocks of a thread which fails to start are taken by the others
+        for (i = 1; i < threads; i += 1)
+        {
+            workers[i].solve = solve;
+            workers[i].isStarted = thrd_create(&workers[i].thread,
+                                               runSolve,
+                                               &workers[i]) == thrd_success;
+        }
+        runSolve(&worker);
+
+        for (i = 1; i < threads; i += 1)
+        {
+            if (workers[i].isStarted)
+            {
+                thrd_join(workers[i].thread, NULL);
+            }
+        }
+
+        first = solve->last;
+    }
+
+    free(workers);
+}
+
+
+/*
+@context
+    * Solves blocks of the current group until none are left.
+    * Run by every thread of the solve.
+
+@parameters
+    * worker
+        * Thread solving the blocks.
+
+@return
+    * Always `0` (required by `thrd_create`).
+*/
+static int runSolve(void *worker)
+{
+    solve_t *solve;
+    uint64_t next;
+
+    solve = ((worker_t *)worker)->solve;
+
+    while ((next = atomic_fetch_add(&solve->next, 1)) < solve->last)
+    {
+        solveBlock(solve, solve->blocks[next]);
+    }
+
+    return 0;
+}
+
+
+/*
+@context
+    * Solves every state of a block from its highest index down.
+    * Digits (and the bitboards and counts of each symbol) are updated as
+      the index is decremented rather than found again for each index.
+
+@parameters
+    * solve
+        * Solve the block is within.
+    * block
+        * High digits of every index of the block.
+*/
+static void solveBlock(solve_t  *solve,
+                       uint64_t  block)
+{
+    state_t state;
+    uint64_t index, count, rest, i;
+    uint8_t cell, cells;
+
+    cells = solve->retrograde->cells;
+    count = getPower(solve->lowDigits);
+    index = ((block + 1) * count) - 1;
+
+    memset(state.digits, 0, sizeof(state.digits));
+    clearBitboard(&state.stones[0]);
+    clearBitboard(&state.stones[1]);
+    state.counts[0] = 0;
+    state.counts[1] = 0;
+
+    rest = index;
+    for (cell = 0; cell < cells; cell += 1)
+    {
+        setDigit(solve, &state, cell, rest % 3);
+        rest /= 3;
+    }
+
+    for (i = 0; i < count; i += 1)
+    {
+        solve->retrograde->values[index] = solveState(solve, &state, index);
+        if (i + 1 == count)
+        {
+            break;
+        }
+
+        // decrements the low digits - borrowing from each `0` digit
+        index -= 1;
+        for (cell = 0; state.digits[cell] == 0; cell += 1)
+        {
+            setDigit(solve, &state, cell, 2);
+        }
+        setDigit(solve, &state, cell, state.digits[cell] - 1);
+    }
+}
+
+
+/*
+@context
+    * Sets the digit of a cell within the state being solved.
+
+@parameters
+    * solve
+        * Solve the state is within.
+    * state
+        * State to set the digit of.
+    * cell
+        * Cell to set the digit of.
+    * digit
+        * Digit to set (`0` empty, `1` nought and `2` cross).
+*/
+static void setDigit(solve_t *solve,
+                     state_t *state,
+                     uint8_t  cell,
+                     uint8_t  digit)
+{
+    if (state->digits[cell] != 0)
+    {
+        unsetBit(&state->stones[state->digits[cell] - 1], solve->bits[cell]);
+        state->counts[state->digits[cell] - 1] -= 1;
+    }
+    if (digit != 0)
+    {
+        setBit(&state->stones[digit - 1], solve->bits[cell]);
+        state->counts[digit - 1] += 1;
+    }
+    state->digits[cell] = digit;
+}
+
+
+/*
+@context
+    * Solves a state from the states its moves lead to (already solved as
+      every move leads to a higher index).
+
+@parameters
+    * solve
+        * Solve the state is within.
+    * state
+        * Digits, bitboards and counts of the state.
+    * index
+        * Index of the state.
+
+@return
+    * Result and distance of the state (`0` if unreachable).
+*/
+static uint8_t solveState(solve_t  *solve,
+                          state_t  *state,
+                          uint64_t  index)
+{
+    const uint8_t *values;
+    uint8_t self, cell, value, distance, fewestWin, mostLoss;
+    bool isDraw, isWin;
+
+    // noughts move first so have the same or 1 more symbol than crosses
+    if (state->counts[0] == state->counts[1])
+    {
+        self = 0;
+    }
+    else if (state->counts[0] == state->counts[1] + 1)
+    {
+        self = 1;
+    }
+    else
+    {
+        return 0;
+    }
+
+    // game ends at the first win which must be from the last symbol to move
+    if (hasLine(&state->stones[self], solve->retrograde->length))
+    {
+        return 0;
+    }
+    if (hasLine(&state->stones[1 - self], solve->retrograde->length))
+    {
+        return RESULT_LOSS << RESULT_SHIFT;
+    }
+    if (state->counts[0] + state->counts[1] == solve->retrograde->cells)
+    {
+        return RESULT_DRAW << RESULT_SHIFT;
+    }
+
+    // a win as soon as possible, else a draw, else a loss as late as possible
+    values = solve->retrograde->values;
+    isWin = false;
+    isDraw = false;
+    fewestWin = DISTANCE_MASK;
+    mostLoss = 0;
+
+    for (cell = 0; cell < solve->retrograde->cells; cell += 1)
+    {
+        if (state->digits[cell] != 0)
+        {
+            continue;
+        }
+
+        value = values[index + ((self + 1) * solve->powers[cell])];
+        distance = (value & DISTANCE_MASK) + 1;
+
+        if (value >> RESULT_SHIFT == RESULT_LOSS)
+        {
+            isWin = true;
+            fewestWin = distance < fewestWin ? distance : fewestWin;
+        }
+        else if (value >> RESULT_SHIFT == RESULT_DRAW)
+        {
+            isDraw = true;
+        }
+        else
+        {
+            mostLoss = distance > mostLoss ? distance : mostLoss;
+        }
+    }
+
+    if (isWin)
+    {
+        return (RESULT_WIN << RESULT_SHIFT) | fewestWin;
+    }
+    if (isDraw)
+    {
+        return RESULT_DRAW << RESULT_SHIFT;
+    }
+    return (RESULT_LOSS << RESULT_SHIFT) | mostLoss;
+}
+
+
+/* ------------------------------ END  PRIVATE ------------------------------ */
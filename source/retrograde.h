@@ -0,0 +1,69 @@
+/*
+@context
+    * Provides databases of every state of small boards solved by retrograde
+      analysis (backward induction) instead of searching states 1 at a time.
+        * Every state is indexed by its base 3 position index (see
+          `position.h`) - 1 byte for each of the `3^cells` indexes.
+        * States which end the game are labelled with the same rules as
+          `isWin` and `isDraw` (a line of the board's length, or a full
+          board).
+        * Every other state is solved from the states its moves lead to - a
+          win if any move leads to a loss of the other symbol, else a draw if
+          any move leads to a draw, else a loss.
+    * A move always adds a digit to the index so leads to a higher index -
+      states are solved from the highest index down and split between threads
+      in blocks of indexes (see `retrograde.c`).
+    * Each state holds its result and the moves until the game ends for the
+      symbol to move (the fewest for a win, the most for a loss) so scores
+      are the same as an exact search (`getBestMoveScore`).
+    * States are indexed with noughts moving first (same as the opening
+      book) - states where crosses moved first are looked up with each
+      symbol swapped.
+    * Databases are saved to files which are mapped instead of read when
+      loaded (`loadRetrograde`) so lookups are only a memory read.
+*/
+
+
+#ifndef _RETROGRADE_H
+    #define _RETROGRADE_H
+
+    #include <stdbool.h>
+    #include <stdint.h>
+
+    #include "board.h"
+    #include "score.h"
+
+
+    // most cells of a board with a database (`3^16` bytes - 43 MB for 4x4)
+    static const uint8_t RETROGRADE_MAX_CELLS = 16;
+
+    // version of the database files written by `saveRetrograde`
+    static const uint32_t RETROGRADE_FILE_VERSION = 1;
+
+
+    typedef struct retrograde_s retrograde_t;
+
+
+    retrograde_t *solveRetrograde(uint8_t size,
+                                  uint8_t length,
+                                  uint8_t threads);
+    retrograde_t *loadRetrograde(const char *path);
+    bool saveRetrograde(retrograde_t *retrograde,
+                        const char   *path);
+    void freeRetrograde(retrograde_t *retrograde);
+
+    uint8_t getRetrogradeSize(retrograde_t *retrograde);
+    uint8_t getRetrogradeLength(retrograde_t *retrograde);
+    uint64_t getRetrogradeCount(retrograde_t *retrograde);
+
+    bool getRetrogradeScore(retrograde_t *retrograde,
+                            board_t      *board,
+                            char          symbol,
+                            score_t      *score);
+    bool lookupRetrograde(retrograde_t *retrograde,
+                          board_t      *board,
+                          char          symbolSelf,
+                          uint8_t      *move,
+                          score_t      *score);
+
+#endif
@@ -0,0 +1,38 @@
+/*
+@context
+    * Provides the score of a state and how its wins and losses are encoded.
+    * Scores are for the symbol the score is of and are the negation of the
+      other symbol's score.
+    * A win `n` moves away scores `SCORE_WIN - n` and a loss `n` moves away
+      `SCORE_LOSE + n` (mate distance) so sooner wins and later losses score
+      higher - every game ends within `SCORE_MATE_MAX` moves (board filled).
+    * Heuristic scores of states not searched to their end are never further
+      than `SCORE_EVAL_MAX` from a draw so never collide with a win or loss.
+*/
+
+
+#ifndef _SCORE_H
+    #define _SCORE_H
+
+    #include <stdint.h>
+
+    #include "board.h"
+
+
+    typedef int32_t score_t;
+
+
+    // base scores of each end state
+    static const score_t SCORE_WIN = 1000000000;
+    static const score_t SCORE_LOSE = -1000000000;
+    static const score_t SCORE_DRAW = 0;
+
+    // most moves until any game ends
+    static const score_t SCORE_MATE_MAX = BOARD_MAX_SIZE * BOARD_MAX_SIZE;
+
+    // furthest heuristic score from a draw - below every win score
+    static const score_t SCORE_EVAL_MAX = 1000000000
+                                        - (BOARD_MAX_SIZE * BOARD_MAX_SIZE)
+                                        - 1;
+
+#endif
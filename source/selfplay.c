@@ -0,0 +1,795 @@
+/*
+@context
+    * Plays games between 2 engines without the interface to measure how
+      fast and how strong each is.
+        * `./selfplay [--games N] [--threads N] [--size N] [--length N]
+          [--first PLAYER] [--second PLAYER]`
+        * Each player is a kind then any of its limits - `KIND[:LIMIT=N]...`
+          such as `minimax:depth=4` or `mcts:time=20`.
+            * Kinds are `minimax`, `mcts` (random playouts),
+              `mcts-heuristic` (heuristic playouts) and `random` (any empty
+              cell).
+            * Limits are `nodes`, `time` (milliseconds) and `depth` (see
+              `limits_t`) - minimax without a limit searches to the end of
+              every game and MCTS without a limit makes `MCTS_PLAYOUTS`
+              playouts.
+    * Games are split between threads, each with its own engine for each
+      player (kept for every game the thread plays, as a server would).
+    * Players swap symbols every game and each pair of games is opened by
+      noughts in a different cell (games `2i` and `2i + 1` in cell `i`) so
+      deterministic players still play different games.
+    * Prints a line of JSON of the games per second and results, then a line
+      for each player of its results and the time of its moves (mean,
+      percentiles and most).
+    * Built with `make selfplay` - with the opening book (as the program).
+*/
+
+
+#include <assert.h>
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <threads.h>
+
+#include "board.h"
+#include "mcts.h"
+#include "minimax.h"
+#include "timer.h"
+
+
+// how each kind of player moves
+static const uint8_t PLAYER_MINIMAX = 0;
+static const uint8_t PLAYER_MCTS = 1;
+static const uint8_t PLAYER_MCTS_HEURISTIC = 2;
+static const uint8_t PLAYER_RANDOM = 3;
+
+// playouts of an MCTS player given no limit and the bytes of its tree
+static const uint64_t MCTS_PLAYOUTS = 10000;
+static const size_t MCTS_MEMORY = (size_t)1 << 24;
+
+static const double NS_PER_S = 1e9;
+
+// move times allocated before any more are needed (doubled once full)
+static const uint64_t FIRST_CAPACITY = 256;
+
+
+// engine playing one side of every game
+typedef struct
+{
+    const char *name;
+    uint8_t kind;
+    limits_t limits;
+} player_t;
+
+// games shared by every thread
+typedef struct
+{
+    player_t players[2];
+    uint8_t size;
+    uint8_t length;
+    uint32_t games;
+
+    // index of the next game to play
+    atomic_uint_fast32_t next;
+} match_t;
+
+// results and move times of a player
+typedef struct
+{
+    uint32_t wins;
+    uint32_t draws;
+    uint32_t losses;
+    uint64_t *times;
+    uint64_t count;
+    uint64_t capacity;
+} tally_t;
+
+// thread playing games with an engine of its own for each player
+typedef struct
+{
+    thrd_t thread;
+    bool isStarted;
+    match_t *match;
+    engine_t *engines[2];
+    tally_t tallies[2];
+    uint64_t random;
+} worker_t;
+
+
+static int runMatch(void *worker);
+static void playGame(worker_t *worker,
+                     board_t  *board,
+                     uint32_t  game);
+static uint8_t getPlayerMove(worker_t *worker,
+                             uint8_t   player,
+                             board_t  *board,
+                             char      symbol);
+
+static void addTime(tally_t  *tally,
+                    uint64_t  time);
+static void mergeTally(tally_t       *tally,
+                       const tally_t *other);
+static void printPlayer(const char *side,
+                        player_t   *player,
+                        tally_t    *tally);
+static int compareTimes(const void *first,
+                        const void *second);
+static double getPercentile(const tally_t *tally,
+                            uint8_t        percent);
+
+static bool parseOptions(int       argc,
+                         char     *argv[],
+                         match_t  *match,
+                         uint8_t  *threads);
+static bool parsePlayer(const char *text,
+                        player_t   *player);
+static bool parseNumber(const char *text,
+                        uint64_t    max,
+                        uint64_t   *value);
+
+
+/* ------------------------------ START PUBLIC ------------------------------ */
+
+
+/*
+@context
+    * Entry point of the self-play driver.
+    * Plays every game then prints the results (see top of file).
+
+@parameters
+    * argc
+        * Number of command line arguments.
+    * argv
+        * Options of the games (see top of file).
+
+@return
+    * Indicates if the options were valid and every game was played.
+*/
+int main(int   argc,
+         char *argv[])
+{
+    match_t match;
+    engineconfig_t config;
+    worker_t *workers;
+    tally_t totals[2];
+    uint64_t start, time;
+    uint8_t threads, i, j;
+
+    if (!parseOptions(argc - 1, argv + 1, &match, &threads))
+    {
+        fprintf(stderr,
+                "usage: %s [--games N] [--threads N] [--size N] "
+                "[--length N] [--first PLAYER] [--second PLAYER]\n"
+                "       PLAYER is minimax, mcts, mcts-heuristic or random "
+                "then any of :nodes=N :time=MS :depth=N\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    workers = calloc(threads, sizeof(worker_t));
+    assert(workers != NULL);
+
+    for (i = 0; i < threads; i += 1)
+    {
+        workers[i].match = &match;
+        for (j = 0; j < 2; j += 1)
+        {
+            workers[i].engines[j] = NULL;
+            if (match.players[j].kind == PLAYER_MINIMAX)
+            {
+                initEngineConfig(&config);
+                config.limits = match.players[j].limits;
+                workers[i].engines[j] = initEngine(&config);
+            }
+        }
+    }
+
+    start = getTime();
+
+    // games of a thread which fails to start are played by the others
+    for (i = 1; i < threads; i += 1)
+    {
+        workers[i].isStarted = thrd_create(&workers[i].thread,
+                                           runMatch,
+                                           &workers[i]) == thrd_success;
+    }
+    runMatch(&workers[0]);
+
+    for (i = 1; i < threads; i += 1)
+    {
+        if (workers[i].isStarted)
+        {
+            thrd_join(workers[i].thread, NULL);
+        }
+    }
+
+    time = getTime() - start;
+
+    memset(totals, 0, sizeof(totals));
+    for (i = 0; i < threads; i += 1)
+    {
+        for (j = 0; j < 2; j += 1)
+        {
+            mergeTally(&totals[j], &workers[i].tallies[j]);
+            free(workers[i].tallies[j].times);
+            if (workers[i].engines[j] != NULL)
+            {
+                freeEngine(workers[i].engines[j]);
+            }
+        }
+    }
+    free(workers);
+
+    printf("{\"games\": %u, \"threads\": %u, \"board\": \"%ux%u\", "
+           "\"length\": %u, \"seconds\": %f, \"games_per_second\": %.1f, "
+           "\"first_wins\": %u, \"draws\": %u, \"second_wins\": %u}\n",
+           match.games, threads, match.size, match.size, match.length,
+           time / NS_PER_S,
+           time > 0 ? match.games / (time / NS_PER_S) : 0.0,
+           totals[0].wins, totals[0].draws, totals[1].wins);
+    printPlayer("first", &match.players[0], &totals[0]);
+    printPlayer("second", &match.players[1], &totals[1]);
+
+    free(totals[0].times);
+    free(totals[1].times);
+
+    return EXIT_SUCCESS;
+}
+
+
+/* ------------------------------- END PUBLIC ------------------------------- */
+/* ----------------------------- START  PRIVATE ----------------------------- */
+
+
+/*
+@context
+    * Plays games of the match until none are left.
+    * Run by every thread of the match.
+
+@parameters
+    * worker
+        * Thread playing the games.
+
+@return
+    * Always `0` (required by `thrd_create`).
+*/
+static int runMatch(void *worker)
+{
+    worker_t *self;
+    boardstorage_t storage;
+    board_t *board;
+    uint32_t game;
+
+    self = worker;
+    board = initBoardStorage(&storage, self->match->size, self->match->length);
+
+    while ((game = atomic_fetch_add(&self->match->next, 1))
+           < self->match->games)
+    {
+        playGame(self, board, game);
+    }
+
+    return 0;
+}
+
+
+/*
+@context
+    * Plays a game of the match and adds its result and move times to the
+      tallies of `worker`.
+
+@parameters
+    * worker
+        * Thread playing the game.
+    * board
+        * Board of the thread (reset before the game).
+    * game
+        * Index of the game (chooses the opening and symbol of each player).
+*/
+static void playGame(worker_t *worker,
+                     board_t  *board,
+                     uint32_t  game)
+{
+    uint64_t start;
+    uint8_t cells, player, move;
+    char symbol;
+
+    resetBoard(board);
+    cells = worker->match->size * worker->match->size;
+
+    // random players of a game move the same whichever thread plays it
+    worker->random = ((uint64_t)game << 1) | 1;
+
+    // first player has noughts in even games
+    player = game % 2;
+    symbol = NOUGHT;
+
+    while (true)
+    {
+        if (getMoveCount(board) == 0)
+        {
+            move = (game / 2) % cells;
+        }
+        else
+        {
+            start = getTime();
+            move = getPlayerMove(worker, player, board, symbol);
+            addTime(&worker->tallies[player], getTime() - start);
+        }
+        makeMove(board, move, symbol);
+
+        if (isWin(board, symbol))
+        {
+            worker->tallies[player].wins += 1;
+            worker->tallies[1 - player].losses += 1;
+            return;
+        }
+        if (isFull(board))
+        {
+            worker->tallies[0].draws += 1;
+            worker->tallies[1].draws += 1;
+            return;
+        }
+
+        player = 1 - player;
+        symbol = symbol == NOUGHT ? CROSS : NOUGHT;
+    }
+}
+
+
+/*
+@context
+    * Gets the move of a player within a game which has not ended.
+
+@parameters
+    * worker
+        * Thread playing the game (holding the engine of each player).
+    * player
+        * Index of the player to move (`0` first, `1` second).
+    * board
+        * Current state of the game.
+    * symbol
+        * Symbol of the player.
+
+@return
+    * Cell of the player's move.
+*/
+static uint8_t getPlayerMove(worker_t *worker,
+                             uint8_t   player,
+                             board_t  *board,
+                             char      symbol)
+{
+    const player_t *self;
+    score_t score;
+    uint8_t cells, empty, cell;
+
+    self = &worker->match->players[player];
+
+    if (self->kind == PLAYER_MINIMAX)
+    {
+        return getEngineMove(worker->engines[player], board, symbol, &score);
+    }
+    if (self->kind == PLAYER_MCTS || self->kind == PLAYER_MCTS_HEURISTIC)
+    {
+        return getBestMoveMCTS(board,
+                               symbol,
+                               &self->limits,
+                               MCTS_MEMORY,
+                               1,
+                               self->kind == PLAYER_MCTS ? MCTS_RANDOM
+                                                         : MCTS_HEURISTIC,
+                               &score);
+    }
+
+    // xorshift of the game's seed chooses any empty cell
+    worker->random ^= worker->random << 13;
+    worker->random ^= worker->random >> 7;
+    worker->random ^= worker->random << 17;
+
+    cells = getSize(board) * getSize(board);
+    empty = worker->random % getEmptyCount(board);
+    for (cell = 0; cell < cells; cell += 1)
+    {
+        if (getCell(board, cell) == EMPTY)
+        {
+            if (empty == 0)
+            {
+                break;
+            }
+            empty -= 1;
+        }
+    }
+
+    return cell;
+}
+
+
+/*
+@context
+    * Adds the time of a move to a tally.
+
+@parameters
+    * tally
+        * Tally of the player which moved.
+    * time
+        * Nanoseconds the move took.
+*/
+static void addTime(tally_t  *tally,
+                    uint64_t  time)
+{
+    if (tally->count == tally->capacity)
+    {
+        tally->capacity = tally->capacity > 0 ? tally->capacity * 2
+                                              : FIRST_CAPACITY;
+        tally->times = realloc(tally->times,
+                               sizeof(uint64_t) * tally->capacity);
+        assert(tally->times != NULL);
+    }
+
+    tally->times[tally->count] = time;
+    tally->count += 1;
+}
+
+
+/*
+@context
+    * Adds the results and move times of `other` to `tally`.
+
+@parameters
+    * tally
+        * Tally to add to.
+    * other
+        * Tally of the same player from another thread.
+*/
+static void mergeTally(tally_t       *tally,
+                       const tally_t *other)
+{
+    uint64_t i;
+
+    tally->wins += other->wins;
+    tally->draws += other->draws;
+    tally->losses += other->losses;
+
+    for (i = 0; i < other->count; i += 1)
+    {
+        addTime(tally, other->times[i]);
+    }
+}
+
+
+/*
+@context
+    * Prints a line of JSON of the results and move times of a player.
+    * Sorts the move times of `tally`.
+
+@parameters
+    * side
+        * Which player (`first` or `second`).
+    * player
+        * Player to print.
+    * tally
+        * Results and move times of the player (from every thread).
+*/
+static void printPlayer(const char *side,
+                        player_t   *player,
+                        tally_t    *tally)
+{
+    uint64_t total, i;
+
+    total = 0;
+    for (i = 0; i < tally->count; i += 1)
+    {
+        total += tally->times[i];
+    }
+    if (tally->count > 0)
+    {
+        qsort(tally->times, tally->count, sizeof(uint64_t), compareTimes);
+    }
+
+    printf("{\"player\": \"%s\", \"engine\": \"%s\", \"wins\": %u, "
+           "\"draws\": %u, \"losses\": %u, \"moves\": %" PRIu64 ", "
+           "\"mean_ms\": %.3f, \"p50_ms\": %.3f, \"p90_ms\": %.3f, "
+           "\"p99_ms\": %.3f, \"max_ms\": %.3f}\n",
+           side, player->name, tally->wins, tally->draws, tally->losses,
+           tally->count,
+           tally->count > 0 ? (double)total / tally->count / NS_PER_MS : 0.0,
+           getPercentile(tally, 50),
+           getPercentile(tally, 90),
+           getPercentile(tally, 99),
+           getPercentile(tally, 100));
+}
+
+
+/*
+@context
+    * Orders move times from the fastest (for `qsort`).
+
+@parameters
+    * first
+        * Time to compare.
+    * second
+        * Time to compare with.
+
+@return
+    * Negative if `first` is faster, positive if slower, otherwise `0`.
+*/
+static int compareTimes(const void *first,
+                        const void *second)
+{
+    uint64_t a, b;
+
+    a = *(const uint64_t *)first;
+    b = *(const uint64_t *)second;
+
+    return (a > b) - (a < b);
+}
+
+
+/*
+@context
+    * Gets the time below which `percent` of the moves of a tally took
+      (nearest rank).
+
+@parameters
+    * tally
+        * Tally with its move times sorted.
+    * percent
+        * Percentile to get (`100` is the slowest move).
+
+@return
+    * Milliseconds of the move at the percentile (`0` without moves).
+*/
+static double getPercentile(const tally_t *tally,
+                            uint8_t        percent)
+{
+    if (tally->count == 0)
+    {
+        return 0.0;
+    }
+
+    return (double)tally->times[((tally->count - 1) * percent) / 100]
+           / NS_PER_MS;
+}
+
+
+/*
+@context
+    * Reads the options of the match.
+
+@parameters
+    * argc
+        * Number of options.
+    * argv
+        * Options to read.
+    * match
+        * Set to the board, games and players of the match.
+    * threads
+        * Set to the number of threads to play with.
+
+@return
+    * Whether every option was known and had a valid value.
+*/
+static bool parseOptions(int       argc,
+                         char     *argv[],
+                         match_t  *match,
+                         uint8_t  *threads)
+{
+    player_t player;
+    uint64_t value;
+    int i;
+
+    match->size = 3;
+    match->length = 0;
+    match->games = 100;
+    atomic_init(&match->next, 0);
+    *threads = 1;
+
+    parsePlayer("minimax", &match->players[0]);
+    parsePlayer("mcts", &match->players[1]);
+
+    // every option has a value
+    for (i = 0; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--games") == 0
+            && parseNumber(argv[i + 1], UINT32_MAX, &value))
+        {
+            match->games = value;
+        }
+        else if (strcmp(argv[i], "--threads") == 0
+                 && parseNumber(argv[i + 1], UINT8_MAX, &value) && value > 0)
+        {
+            *threads = value;
+        }
+        else if (strcmp(argv[i], "--size") == 0
+                 && parseNumber(argv[i + 1], BOARD_MAX_SIZE, &value)
+                 && value > 0)
+        {
+            match->size = value;
+        }
+        else if (strcmp(argv[i], "--length") == 0
+                 && parseNumber(argv[i + 1], BOARD_MAX_SIZE, &value)
+                 && value > 0)
+        {
+            match->length = value;
+        }
+        else if (strcmp(argv[i], "--first") == 0
+                 && parsePlayer(argv[i + 1], &player))
+        {
+            match->players[0] = player;
+        }
+        else if (strcmp(argv[i], "--second") == 0
+                 && parsePlayer(argv[i + 1], &player))
+        {
+            match->players[1] = player;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    // whole row, column or diagonal unless given
+    if (match->length == 0)
+    {
+        match->length = match->size;
+    }
+
+    return i == argc && match->length <= match->size;
+}
+
+
+/*
+@context
+    * Reads a player from `text` - its kind then any of its limits
+      (`KIND[:LIMIT=N]...`).
+
+@parameters
+    * text
+        * Text of the player.
+    * player
+        * Set to the player.
+
+@return
+    * Whether `text` was a known kind with known limits of valid values.
+*/
+static bool parsePlayer(const char *text,
+                        player_t   *player)
+{
+    char buffer[64];
+    char *field, *value, *rest;
+    uint64_t number;
+
+    if (strlen(text) >= sizeof(buffer))
+    {
+        return false;
+    }
+    strcpy(buffer, text);
+
+    player->name = text;
+    player->limits.nodes = 0;
+    player->limits.time = 0;
+    player->limits.depth = 0;
+
+    rest = strchr(buffer, ':');
+    if (rest != NULL)
+    {
+        *rest = '\0';
+        rest += 1;
+    }
+
+    if (strcmp(buffer, "minimax") == 0)
+    {
+        player->kind = PLAYER_MINIMAX;
+    }
+    else if (strcmp(buffer, "mcts") == 0)
+    {
+        player->kind = PLAYER_MCTS;
+    }
+    else if (strcmp(buffer, "mcts-heuristic") == 0)
+    {
+        player->kind = PLAYER_MCTS_HEURISTIC;
+    }
+    else if (strcmp(buffer, "random") == 0)
+    {
+        player->kind = PLAYER_RANDOM;
+    }
+    else
+    {
+        return false;
+    }
+
+    // each limit is `LIMIT=N` ended by `:` or the end of `text`
+    while (rest != NULL)
+    {
+        field = rest;
+        rest = strchr(rest, ':');
+        if (rest != NULL)
+        {
+            *rest = '\0';
+            rest += 1;
+        }
+
+        value = strchr(field, '=');
+        if (value == NULL)
+        {
+            return false;
+        }
+        *value = '\0';
+        value += 1;
+
+        if (strcmp(field, "nodes") == 0
+            && parseNumber(value, UINT64_MAX, &number))
+        {
+            player->limits.nodes = number;
+        }
+        else if (strcmp(field, "time") == 0
+                 && parseNumber(value, UINT32_MAX, &number))
+        {
+            player->limits.time = number;
+        }
+        else if (strcmp(field, "depth") == 0
+                 && parseNumber(value, UINT8_MAX, &number))
+        {
+            player->limits.depth = number;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    // playouts always end with their game so need a playout or time limit
+    if ((player->kind == PLAYER_MCTS || player->kind == PLAYER_MCTS_HEURISTIC)
+        && player->limits.nodes == 0 && player->limits.time == 0)
+    {
+        player->limits.nodes = MCTS_PLAYOUTS;
+    }
+
+    return true;
+}
+
+
+/*
+@context
+    * Reads a decimal number from `text`.
+
+@parameters
+    * text
+        * Text of only the digits of the number.
+    * max
+        * Largest number allowed.
+    * value
+        * Set to the number.
+
+@return
+    * Whether `text` was a number no larger than `max`.
+*/
+static bool parseNumber(const char *text,
+                        uint64_t    max,
+                        uint64_t   *value)
+{
+    *value = 0;
+    if (*text == '\0')
+    {
+        return false;
+    }
+
+    for (; *text != '\0'; text += 1)
+    {
+        if (*text < '0' || *text > '9'
+            || *value > (max - (*text - '0')) / 10)
+        {
+            return false;
+        }
+        *value = (*value * 10) + (*text - '0');
+    }
+
+    return true;
+}
+
+
+/* ------------------------------ END  PRIVATE ------------------------------ */
@@ -0,0 +1,526 @@
+// sockets and `fdopen` are POSIX so are hidden by strict C17 without this
+#define _POSIX_C_SOURCE 200809L
+
+#include "server.h"
+
+#include <arpa/inet.h>
+#include <inttypes.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "board.h"
+#include "minimax.h"
+#include "position.h"
+
+
+// entries of the transposition table shared by every request
+static const uint32_t TABLE_SIZE = 1 << 20;
+
+// longest request - every cell of the largest board, its win length, newline
+#define REQUEST_MAX ((BOARD_MAX_SIZE * BOARD_MAX_SIZE) + 8)
+
+static const char CELL_EMPTY_DOT = '.';
+static const char CELL_EMPTY_DASH = '-';
+static const char LENGTH_SEPARATOR = ':';
+
+// connections waiting to be accepted
+static const int BACKLOG = 16;
+
+
+static bool parseOptions(int          argc,
+                         char        *argv[],
+                         limits_t    *limits,
+                         uint16_t    *port,
+                         const char **cache);
+static bool parseNumber(const char *text,
+                        uint64_t    max,
+                        uint64_t   *value);
+static bool servePort(uint16_t    port,
+                      engine_t   *engine,
+                      const char *cache);
+static void serveStream(FILE     *in,
+                        FILE     *out,
+                        engine_t *engine);
+static const char *parseRequest(char       *line,
+                                position_t *position);
+static void answerRequest(const position_t *position,
+                          engine_t         *engine,
+                          boardstorage_t   *storage,
+                          board_t         **board,
+                          FILE             *out);
+
+
+/* ------------------------------ START PUBLIC ------------------------------ */
+
+
+/*
+@context
+    * Runs the engine mode until its input ends (or forever with `--port`).
+
+@parameters
+    * argc
+        * Number of options.
+    * argv
+        * Options of the engine mode (after `ARG_ENGINE`).
+        * `--nodes N`, `--time MS` and `--depth N` limit each search.
+        * `--port PORT` serves connections to `PORT` instead of stdin.
+        * `--cache FILE` loads the transposition table from `FILE` (if it
+          exists) and saves it back once the input (or each connection)
+          ends so later runs start with every state already solved.
+
+@return
+    * Whether the options were valid (and the port could be listened on).
+*/
+bool runServer(int   argc,
+               char *argv[])
+{
+    engineconfig_t config;
+    engine_t *engine;
+    const char *cache;
+    uint16_t port;
+    bool isServed;
+
+    initEngineConfig(&config);
+    config.tableSize = TABLE_SIZE;
+    if (!parseOptions(argc, argv, &config.limits, &port, &cache))
+    {
+        fprintf(stderr,
+                "usage: %s [--nodes N] [--time MS] [--depth N] "
+                "[--port PORT] [--cache FILE]\n",
+                ARG_ENGINE);
+        return false;
+    }
+
+    // a missing (or outdated) cache starts empty and is written once served
+    engine = cache == NULL ? NULL : loadEngine(&config, cache);
+    if (engine == NULL)
+    {
+        engine = initEngine(&config);
+    }
+
+    isServed = true;
+    if (port == 0)
+    {
+        serveStream(stdin, stdout, engine);
+        if (cache != NULL && !saveEngine(engine, cache))
+        {
+            perror("cache");
+        }
+    }
+    else
+    {
+        isServed = servePort(port, engine, cache);
+    }
+
+    freeEngine(engine);
+
+    return isServed;
+}
+
+
+/* ------------------------------- END PUBLIC ------------------------------- */
+/* ----------------------------- START  PRIVATE ----------------------------- */
+
+
+/*
+@context
+    * Reads the options of the engine mode.
+
+@parameters
+    * argc
+        * Number of options.
+    * argv
+        * Options to read.
+    * limits
+        * Set to the limits of each search (`0` for no limit).
+    * port
+        * Set to the port to serve (`0` to serve stdin).
+    * cache
+        * Set to the path of the file to cache the table in (`NULL` for no
+          file).
+
+@return
+    * Whether every option was known and had a valid value.
+*/
+static bool parseOptions(int          argc,
+                         char        *argv[],
+                         limits_t    *limits,
+                         uint16_t    *port,
+                         const char **cache)
+{
+    uint64_t value;
+    int i;
+
+    limits->nodes = 0;
+    limits->time = 0;
+    limits->depth = 0;
+    *port = 0;
+    *cache = NULL;
+
+    // every option has a value
+    for (i = 0; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--nodes") == 0
+            && parseNumber(argv[i + 1], UINT64_MAX, &value))
+        {
+            limits->nodes = value;
+        }
+        else if (strcmp(argv[i], "--time") == 0
+                 && parseNumber(argv[i + 1], UINT32_MAX, &value))
+        {
+            limits->time = value;
+        }
+        else if (strcmp(argv[i], "--depth") == 0
+                 && parseNumber(argv[i + 1], UINT8_MAX, &value))
+        {
+            limits->depth = value;
+        }
+        else if (strcmp(argv[i], "--port") == 0
+                 && parseNumber(argv[i + 1], UINT16_MAX, &value) && value > 0)
+        {
+            *port = value;
+        }
+        else if (strcmp(argv[i], "--cache") == 0 && argv[i + 1][0] != '\0')
+        {
+            *cache = argv[i + 1];
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return i == argc;
+}
+
+
+/*
+@context
+    * Reads a decimal number from `text`.
+
+@parameters
+    * text
+        * Text of only the digits of the number.
+    * max
+        * Largest number allowed.
+    * value
+        * Set to the number.
+
+@return
+    * Whether `text` was a number no larger than `max`.
+*/
+static bool parseNumber(const char *text,
+                        uint64_t    max,
+                        uint64_t   *value)
+{
+    *value = 0;
+    if (*text == '\0')
+    {
+        return false;
+    }
+
+    for (; *text != '\0'; text += 1)
+    {
+        if (*text < '0' || *text > '9'
+            || *value > (max - (*text - '0')) / 10)
+        {
+            return false;
+        }
+        *value = (*value * 10) + (*text - '0');
+    }
+
+    return true;
+}
+
+
+/*
+@context
+    * Serves connections to `port` of the loopback address forever.
+    * Connections are served 1 at a time - each until it is closed.
+
+@parameters
+    * port
+        * Port to listen on.
+    * engine
+        * Engine searching each request (within its limits).
+    * cache
+        * Path of the file to save the table to once each connection is
+          closed (`NULL` for no file).
+
+@return
+    * `false` if `port` could not be listened on (never returns otherwise).
+*/
+static bool servePort(uint16_t    port,
+                      engine_t   *engine,
+                      const char *cache)
+{
+    struct sockaddr_in address;
+    int listener, connection, reuse;
+    FILE *in, *out;
+
+    listener = socket(AF_INET, SOCK_STREAM, 0);
+    if (listener < 0)
+    {
+        perror("socket");
+        return false;
+    }
+
+    // a client closing its connection early must not end the server
+    signal(SIGPIPE, SIG_IGN);
+
+    reuse = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+
+    if (bind(listener, (struct sockaddr *)&address, sizeof(address)) < 0
+        || listen(listener, BACKLOG) < 0)
+    {
+        perror("listen");
+        close(listener);
+        return false;
+    }
+
+    while (true)
+    {
+        if ((connection = accept(listener, NULL, NULL)) < 0)
+        {
+            continue;
+        }
+
+        // reading and writing need their own stream (and descriptor)
+        in = fdopen(connection, "r");
+        out = in == NULL ? NULL : fdopen(dup(connection), "w");
+        if (out == NULL)
+        {
+            if (in != NULL)
+            {
+                fclose(in);
+            }
+            else
+            {
+                close(connection);
+            }
+            continue;
+        }
+
+        serveStream(in, out, engine);
+
+        fclose(out);
+        fclose(in);
+
+        if (cache != NULL && !saveEngine(engine, cache))
+        {
+            perror("cache");
+        }
+    }
+}
+
+
+/*
+@context
+    * Answers each request read from `in` until it ends.
+    * Each response is flushed once written so it is not held back waiting
+      for the next request - pipelined requests are already buffered.
+
+@parameters
+    * in
+        * Stream of requests (1 a line).
+    * out
+        * Stream to write each response to.
+    * engine
+        * Engine searching each request (within its limits).
+*/
+static void serveStream(FILE     *in,
+                        FILE     *out,
+                        engine_t *engine)
+{
+    char line[REQUEST_MAX + 2];
+    position_t position;
+    const char *error;
+    boardstorage_t storage;
+    board_t *board;
+    size_t length;
+    int next;
+
+    board = NULL;
+    while (fgets(line, sizeof(line), in) != NULL)
+    {
+        length = strlen(line);
+        if (length > 0 && line[length - 1] != '\n' && !feof(in))
+        {
+            // too long - skip the rest of the line
+            while ((next = fgetc(in)) != EOF && next != '\n');
+            error = "request too long";
+        }
+        else
+        {
+            error = parseRequest(line, &position);
+        }
+
+        if (error != NULL)
+        {
+            fprintf(out, "error %s\n", error);
+        }
+        else
+        {
+            answerRequest(&position, engine, &storage, &board, out);
+        }
+
+        // connection closed by the client
+        if (fflush(out) == EOF)
+        {
+            break;
+        }
+    }
+}
+
+
+/*
+@context
+    * Reads the position of a request.
+
+@parameters
+    * line
+        * Request - `CELLS[:LENGTH]` ending with an optional newline.
+        * Newline (and carriage return) removed.
+    * position
+        * Set to the position of the request.
+
+@return
+    * Reason the request is not valid, `NULL` if it is.
+*/
+static const char *parseRequest(char       *line,
+                                position_t *position)
+{
+    char *separator;
+    uint64_t length;
+    uint16_t cells, noughts, crosses, cell;
+    uint8_t size;
+
+    line[strcspn(line, "\r\n")] = '\0';
+
+    length = 0;
+    separator = strrchr(line, LENGTH_SEPARATOR);
+    if (separator != NULL)
+    {
+        *separator = '\0';
+        if (!parseNumber(separator + 1, BOARD_MAX_SIZE, &length))
+        {
+            return "invalid length";
+        }
+    }
+
+    cells = strlen(line);
+    for (size = 1; size < BOARD_MAX_SIZE && size * size < cells; size += 1);
+    if (cells == 0 || size * size != cells)
+    {
+        return "board not square";
+    }
+    if (length == 0)
+    {
+        length = size;
+    }
+    if (length > size)
+    {
+        return "invalid length";
+    }
+
+    noughts = 0;
+    crosses = 0;
+    for (cell = 0; cell < cells; cell += 1)
+    {
+        if (line[cell] == NOUGHT)
+        {
+            noughts += 1;
+        }
+        else if (line[cell] == CROSS)
+        {
+            crosses += 1;
+        }
+        else if (line[cell] != EMPTY && line[cell] != CELL_EMPTY_DOT
+                 && line[cell] != CELL_EMPTY_DASH)
+        {
+            return "invalid cell";
+        }
+    }
+
+    // noughts move first so never have fewer or more than 1 extra
+    if (noughts != crosses && noughts != crosses + 1)
+    {
+        return "invalid symbol counts";
+    }
+
+    initPosition(position,
+                 size,
+                 length,
+                 noughts == crosses ? NOUGHT : CROSS);
+    for (cell = 0; cell < cells; cell += 1)
+    {
+        if (line[cell] == NOUGHT || line[cell] == CROSS)
+        {
+            setPositionCell(position, cell, line[cell]);
+        }
+    }
+
+    return NULL;
+}
+
+
+/*
+@context
+    * Finds the best move of `position` and writes it as a response.
+
+@parameters
+    * position
+        * Position of the request.
+    * engine
+        * Engine to search with (within its limits).
+        * Searched to the end of every game if there are no limits.
+    * storage
+        * Memory of the board of the server.
+    * board
+        * Board of the server (within `storage`) to decode `position` into.
+        * Initialised again if `NULL` or a different size or win length.
+    * out
+        * Stream to write the response to.
+*/
+static void answerRequest(const position_t *position,
+                          engine_t         *engine,
+                          boardstorage_t   *storage,
+                          board_t         **board,
+                          FILE             *out)
+{
+    uint8_t move;
+    score_t score;
+
+    if (*board == NULL || getSize(*board) != position->size
+        || getLength(*board) != position->length)
+    {
+        *board = initBoardStorage(storage, position->size, position->length);
+    }
+
+    decodePosition(position, *board);
+
+    if (isWin(*board, NOUGHT) || isWin(*board, CROSS) || isFull(*board))
+    {
+        fprintf(out, "none 0\n");
+        return;
+    }
+
+    move = getEngineMove(engine, *board, position->symbol, &score);
+
+    fprintf(out, "%d %" PRId32 "\n", move, score);
+}
+
+
+/* ------------------------------ END  PRIVATE ------------------------------ */
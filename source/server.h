@@ -0,0 +1,37 @@
+/*
+@context
+    * Provides a non-interactive engine mode (`./program --engine`) which
+      answers positions line by line without the interface.
+    * Each request is 1 line of the cells of a square board (row by row) with
+      an optional win length - `CELLS[:LENGTH]`.
+        * Cells are `O`, `X` and empty (` `, `.` or `-`).
+        * Noughts move first so the symbol to move is found from the cells.
+        * e.g. `XO X  O  ` or `.........:3`.
+    * Each response is 1 line of the best move and its score - `MOVE SCORE`.
+        * Scores are as `score.h` - a win `n` moves away is `1000000000 - n`.
+        * `none 0` if the game of the position has already ended.
+        * `error REASON` if the request is not a valid position.
+    * Requests can be pipelined - each is answered in order as it is read.
+    * Reads stdin and writes stdout unless `--port PORT` is given, when each
+      connection to `PORT` (on the loopback address) is served in turn.
+    * Positions are searched to the end of every game unless `--nodes N`,
+      `--time MS` or `--depth N` limit each search.
+    * `--cache FILE` keeps the transposition table in `FILE` between runs -
+      loaded (mapped) at startup and saved once served.
+*/
+
+
+#ifndef _SERVER_H
+    #define _SERVER_H
+
+    #include <stdbool.h>
+
+
+    // argument of the program which runs the engine mode
+    static const char ARG_ENGINE[] = "--engine";
+
+
+    bool runServer(int   argc,
+                   char *argv[]);
+
+#endif
@@ -0,0 +1,139 @@
+#include "stats.h"
+
+#include <string.h>
+#include <threads.h>
+
+
+// searches finishing at once (threads of a batch) add to a total in turn
+static mtx_t lock;
+static once_flag lockFlag = ONCE_FLAG_INIT;
+
+
+static void initLock();
+
+
+/* ------------------------------ START PUBLIC ------------------------------ */
+
+
+/*
+@context
+    * Sets every statistic of `stats` to `0`.
+
+@parameters
+    * stats
+        * Statistics to clear.
+*/
+void clearStats(stats_t *stats)
+{
+    memset(stats, 0, sizeof(stats_t));
+}
+
+
+/*
+@context
+    * Adds the statistics of a search to `total`.
+    * Safe to call from many threads adding to the same `total` at once.
+
+@parameters
+    * total
+        * Statistics to add to.
+    * stats
+        * Statistics of the search to add.
+*/
+void addStats(stats_t       *total,
+              const stats_t *stats)
+{
+    uint16_t depth;
+
+    call_once(&lockFlag, initLock);
+    mtx_lock(&lock);
+
+    total->searches += stats->searches;
+    total->time += stats->time;
+    if (stats->depth > total->depth)
+    {
+        total->depth = stats->depth;
+    }
+
+    for (depth = 0; depth < STATS_DEPTHS; depth += 1)
+    {
+        total->nodes[depth] += stats->nodes[depth];
+        total->cutoffs[depth] += stats->cutoffs[depth];
+        total->firstCutoffs[depth] += stats->firstCutoffs[depth];
+    }
+
+    total->probes += stats->probes;
+    total->hits += stats->hits;
+
+    mtx_unlock(&lock);
+}
+
+
+/*
+@context
+    * Gets the number of states searched at every depth.
+
+@parameters
+    * stats
+        * Statistics to count the states of.
+
+@return
+    * Total states searched.
+*/
+uint64_t getTotalNodes(const stats_t *stats)
+{
+    uint64_t nodes;
+    uint16_t depth;
+
+    nodes = 0;
+    for (depth = 0; depth < STATS_DEPTHS; depth += 1)
+    {
+        nodes += stats->nodes[depth];
+    }
+
+    return nodes;
+}
+
+
+/*
+@context
+    * Gets the number of states pruned at every depth.
+
+@parameters
+    * stats
+        * Statistics to count the prunes of.
+
+@return
+    * Total states pruned.
+*/
+uint64_t getTotalCutoffs(const stats_t *stats)
+{
+    uint64_t cutoffs;
+    uint16_t depth;
+
+    cutoffs = 0;
+    for (depth = 0; depth < STATS_DEPTHS; depth += 1)
+    {
+        cutoffs += stats->cutoffs[depth];
+    }
+
+    return cutoffs;
+}
+
+
+/* ------------------------------- END PUBLIC ------------------------------- */
+/* ----------------------------- START  PRIVATE ----------------------------- */
+
+
+/*
+@context
+    * Initialises the lock of `addStats`.
+    * Only called once - before statistics are first added.
+*/
+static void initLock()
+{
+    mtx_init(&lock, mtx_plain);
+}
+
+
+/* ------------------------------ END  PRIVATE ------------------------------ */
@@ -0,0 +1,72 @@
+/*
+@context
+    * Provides statistics of what searches did - states searched and pruned at
+      each depth, transposition table hits and time taken.
+    * Only collected when compiled with `SEARCH_STATS` defined
+      (`make DEFINES=-DSEARCH_STATS`), otherwise every `STATS_` macro is
+      removed so searches pay nothing for them.
+    * Searches add their statistics to the `stats_t` set by `setStats` once
+      they finish (safe when many searches finish at once).
+    * The portion of prunes made by the first move searched at a depth is
+      `firstCutoffs / cutoffs` (nearer `1` is better move ordering).
+*/
+
+
+#ifndef _STATS_H
+    #define _STATS_H
+
+    #include <stdint.h>
+
+    #include "board.h"
+
+
+    // root is depth `0` and every cell can be filled after it
+    #define STATS_DEPTHS ((BOARD_MAX_SIZE * BOARD_MAX_SIZE) + 1)
+
+
+    typedef struct
+    {
+        // searches added and total nanoseconds they took
+        uint64_t searches;
+        uint64_t time;
+
+        // deepest depth completed by any search (of iterative deepening or to
+        // the end of every game)
+        uint8_t depth;
+
+        // states searched, states pruned and states pruned by the first move
+        // searched at each depth
+        uint64_t nodes[STATS_DEPTHS];
+        uint64_t cutoffs[STATS_DEPTHS];
+        uint64_t firstCutoffs[STATS_DEPTHS];
+
+        // states looked up in the transposition table and how many were found
+        uint64_t probes;
+        uint64_t hits;
+    } stats_t;
+
+
+    #ifdef SEARCH_STATS
+        #define STATS_NODE(stats, depth) ((stats)->nodes[(depth)] += 1)
+        #define STATS_CUTOFF(stats, depth, isFirst) \
+            ((stats)->cutoffs[(depth)] += 1, \
+             (stats)->firstCutoffs[(depth)] += (isFirst))
+        #define STATS_PROBE(stats, isHit) \
+            ((stats)->probes += 1, (stats)->hits += (isHit))
+        #define STATS_DEPTH(stats, completed) ((stats)->depth = (completed))
+    #else
+        #define STATS_NODE(stats, depth) ((void)0)
+        #define STATS_CUTOFF(stats, depth, isFirst) ((void)0)
+        #define STATS_PROBE(stats, isHit) ((void)0)
+        #define STATS_DEPTH(stats, completed) ((void)0)
+    #endif
+
+
+    void clearStats(stats_t *stats);
+    void addStats(stats_t       *total,
+                  const stats_t *stats);
+
+    uint64_t getTotalNodes(const stats_t *stats);
+    uint64_t getTotalCutoffs(const stats_t *stats);
+
+#endif
@@ -0,0 +1,98 @@
+#include "symmetry.h"
+
+#include <assert.h>
+
+
+/* ------------------------------ START PUBLIC ------------------------------ */
+
+
+/*
+@context
+    * Gets where `cell` moves to under every symmetry of a square board.
+    * Faster than calling `transformCell` for each symmetry.
+
+@parameters
+    * size
+        * Width and height of the board.
+    * cell
+        * Position in the board to transform.
+    * cells
+        * Filled with `cell` transformed by each symmetry (indexed by symmetry).
+*/
+void getSymmetricCells(uint8_t size,
+                       uint8_t cell,
+                       uint8_t cells[SYMMETRY_COUNT])
+{
+    uint8_t row, column, last;
+
+    row = cell / size;
+    column = cell % size;
+    last = size - 1;
+
+    // a clockwise quarter turn moves (row, column) to (column, last - row)
+    cells[0] = (row * size) + column;
+    cells[1] = (column * size) + (last - row);
+    cells[2] = ((last - row) * size) + (last - column);
+    cells[3] = ((last - column) * size) + row;
+
+    // same turns after reflecting - (row, column) to (row, last - column)
+    cells[4] = (row * size) + (last - column);
+    cells[5] = ((last - column) * size) + (last - row);
+    cells[6] = ((last - row) * size) + column;
+    cells[7] = (column * size) + row;
+}
+
+
+/*
+@context
+    * Gets where `cell` moves to under a single `symmetry` of a square board.
+
+@parameters
+    * size
+        * Width and height of the board.
+    * cell
+        * Position in the board to transform.
+    * symmetry
+        * Symmetry to transform `cell` by.
+
+@return
+    * Position of `cell` after `symmetry`.
+*/
+uint8_t transformCell(uint8_t size,
+                      uint8_t cell,
+                      uint8_t symmetry)
+{
+    uint8_t cells[SYMMETRY_COUNT];
+
+    assert(symmetry < SYMMETRY_COUNT);
+
+    getSymmetricCells(size, cell, cells);
+    return cells[symmetry];
+}
+
+
+/*
+@context
+    * Gets the symmetry which undoes `symmetry`.
+
+@parameters
+    * symmetry
+        * Symmetry to undo.
+
+@return
+    * Inverse of `symmetry`.
+*/
+uint8_t invertSymmetry(uint8_t symmetry)
+{
+    assert(symmetry < SYMMETRY_COUNT);
+
+    // reflections undo themselves and rotations are undone by the other way
+    if (symmetry & 4)
+    {
+        return symmetry;
+    }
+    return (4 - symmetry) % 4;
+}
+
+
+/* ------------------------------- END PUBLIC ------------------------------- */
@@ -0,0 +1,34 @@
+/*
+@context
+    * Provides the 8 symmetries of a square board (4 rotations and their
+      reflections).
+    * States that are the same after a symmetry have the same optimal moves
+      (also transformed by the symmetry) so only need to be searched once.
+    * Symmetries are numbered `0` to `SYMMETRY_COUNT - 1` where `0` leaves every
+      cell unchanged.
+        * Bit `4` reflects each row (left to right) first.
+        * Bits `0` and `1` are the number of clockwise quarter turns after.
+*/
+
+
+#ifndef _SYMMETRY_H
+    #define _SYMMETRY_H
+
+    #include <stdint.h>
+
+
+    #define SYMMETRY_COUNT 8
+
+    static const uint8_t SYMMETRY_IDENTITY = 0;
+
+
+    void getSymmetricCells(uint8_t size,
+                           uint8_t cell,
+                           uint8_t cells[SYMMETRY_COUNT]);
+
+    uint8_t transformCell(uint8_t size,
+                          uint8_t cell,
+                          uint8_t symmetry);
+    uint8_t invertSymmetry(uint8_t symmetry);
+
+#endif
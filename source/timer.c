@@ -0,0 +1,29 @@
+// `clock_gettime` is POSIX so is hidden by strict C17 without this
+#define _POSIX_C_SOURCE 199309L
+
+#include "timer.h"
+
+#include <time.h>
+
+
+/* ------------------------------ START PUBLIC ------------------------------ */
+
+
+/*
+@context
+    * Gets the time of a monotonic clock (never goes backwards).
+    * Only the difference between 2 times is meaningful.
+
+@return
+    * Current time in nanoseconds.
+*/
+uint64_t getTime()
+{
+    struct timespec time;
+
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return ((uint64_t)time.tv_sec * 1000000000) + time.tv_nsec;
+}
+
+
+/* ------------------------------- END PUBLIC ------------------------------- */
@@ -0,0 +1,18 @@
+/*
+@context
+    * Provides a monotonic clock to measure and limit how long searches take.
+*/
+
+
+#ifndef _TIMER_H
+    #define _TIMER_H
+
+    #include <stdint.h>
+
+
+    static const uint64_t NS_PER_MS = 1000000;
+
+
+    uint64_t getTime();
+
+#endif
@@ -0,0 +1,488 @@
+// `mmap` and file descriptors are POSIX so are hidden by strict C17 without
+// this
+#define _POSIX_C_SOURCE 200809L
+
+#include "transposition.h"
+
+#include <assert.h>
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+// set within the data of every used slot (empty slots are all `0`)
+static const uint64_t DATA_USED = (uint64_t)1 << 24;
+
+// start of every table file and a value whose bytes differ in every byte
+// order (files are only loaded by machines of the same byte order)
+static const char FILE_MAGIC[8] = {'N', 'C', 'T', 'A', 'B', 'L', 'E', '\0'};
+static const uint32_t FILE_BYTE_ORDER = 0x01020304;
+
+// header is padded so the slots after it are aligned to cache lines
+#define FILE_HEADER_BYTES 64
+
+// slots written to a file at once
+#define FILE_CHUNK_SLOTS 4096
+
+
+// shared by every thread without locks - the entry is packed into `data` and
+// stored with `check` (key XOR data) so a slot torn by 2 threads writing at
+// once has a `check` which does not match its `data` and is never used
+typedef struct
+{
+    atomic_uint_fast64_t check;
+    atomic_uint_fast64_t data;
+} slot_t;
+
+struct table_s
+{
+    // number of slots is a power of 2 so a key's index is its low bits
+    uint32_t mask;
+    slot_t *slots;
+
+    // mapping of the file the slots are within (`NULL` if allocated)
+    void *map;
+    size_t mapBytes;
+};
+
+// start of a table file - followed by every slot (`check` then `data`)
+typedef struct
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t slotBytes;
+    uint32_t reserved;
+    uint64_t count;
+} fileheader_t;
+
+static_assert(sizeof(fileheader_t) <= FILE_HEADER_BYTES,
+              "FILE_HEADER_BYTES too small to hold a file header");
+static_assert(sizeof(slot_t) == 2 * sizeof(uint64_t),
+              "slots must be 2 plain words to be mapped from a file");
+
+
+static uint64_t packEntry(entry_t entry);
+static entry_t unpackEntry(uint64_t data);
+static bool loadSlot(slot_t   *slot,
+                     uint64_t  key,
+                     entry_t  *entry);
+static bool isValidHeader(const fileheader_t *header,
+                          size_t              bytes);
+
+
+/* ------------------------------ START PUBLIC ------------------------------ */
+
+
+/*
+@context
+    * Initialises an empty transposition table.
+
+@parameters
+    * size
+        * Number of entries the table can store.
+        * Rounded down to a power of 2 (at least 1).
+
+@return
+    * Empty transposition table.
+*/
+table_t *initTable(uint32_t size)
+{
+    table_t *table;
+    uint32_t count;
+
+    // largest power of 2 not larger than `size`
+    count = 1;
+    while (count <= size / 2)
+    {
+        count *= 2;
+    }
+
+    table = malloc(sizeof(table_t));
+    assert(table != NULL);
+
+    table->mask = count - 1;
+    table->slots = malloc(sizeof(slot_t) * count);
+    assert(table->slots != NULL);
+    table->map = NULL;
+    table->mapBytes = 0;
+
+    clearTable(table);
+
+    return table;
+}
+
+
+/*
+@context
+    * Frees `table`.
+
+@parameters
+    * table
+        * Transposition table to free.
+*/
+void freeTable(table_t *table)
+{
+    if (table->map != NULL)
+    {
+        munmap(table->map, table->mapBytes);
+    }
+    else
+    {
+        free(table->slots);
+    }
+    free(table);
+}
+
+
+/*
+@context
+    * Initialises a transposition table from a file written by `saveTable`.
+    * The file is mapped (`mmap`) instead of read so loading takes the same
+      time however large it is - the pages of the file are read as they are
+      first probed and shared by every process which loads it.
+        * Mapped copy-on-write so entries stored only change the pages of
+          this process (never the file or another process).
+    * Files of another version or byte order are not loaded.
+
+@parameters
+    * path
+        * Path of the file to load.
+
+@return
+    * Transposition table with every entry of the file.
+    * `NULL` if the file could not be loaded.
+*/
+table_t *loadTable(const char *path)
+{
+    table_t *table;
+    struct stat status;
+    void *map;
+    int file;
+
+    file = open(path, O_RDONLY);
+    if (file < 0)
+    {
+        return NULL;
+    }
+
+    map = MAP_FAILED;
+    if (fstat(file, &status) == 0 && status.st_size >= FILE_HEADER_BYTES)
+    {
+        map = mmap(NULL,
+                   status.st_size,
+                   PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE,
+                   file,
+                   0);
+    }
+
+    // the mapping stays valid once the file is closed
+    close(file);
+    if (map == MAP_FAILED)
+    {
+        return NULL;
+    }
+
+    if (!isValidHeader(map, status.st_size))
+    {
+        munmap(map, status.st_size);
+        return NULL;
+    }
+
+    table = malloc(sizeof(table_t));
+    assert(table != NULL);
+
+    table->mask = ((const fileheader_t *)map)->count - 1;
+    table->slots = (slot_t *)((char *)map + FILE_HEADER_BYTES);
+    table->map = map;
+    table->mapBytes = status.st_size;
+
+    return table;
+}
+
+
+/*
+@context
+    * Writes every entry of `table` to a file loaded by `loadTable`.
+    * Written to a temporary file then renamed over `path` so processes
+      which already loaded `path` keep the file they mapped and no process
+      loads a partly written file.
+    * Must not be called while another thread stores entries.
+
+@parameters
+    * table
+        * Transposition table to write.
+    * path
+        * Path of the file to write.
+
+@return
+    * Indicates if the whole file was written.
+*/
+bool saveTable(table_t    *table,
+               const char *path)
+{
+    uint8_t header[FILE_HEADER_BYTES];
+    fileheader_t fields;
+    uint64_t *words;
+    char *temporary;
+    FILE *file;
+    uint64_t count, i, j;
+    bool isWritten;
+
+    temporary = malloc(strlen(path) + sizeof(".tmp"));
+    assert(temporary != NULL);
+    strcpy(temporary, path);
+    strcat(temporary, ".tmp");
+
+    words = malloc(sizeof(uint64_t) * 2 * FILE_CHUNK_SLOTS);
+    assert(words != NULL);
+
+    count = (uint64_t)table->mask + 1;
+
+    memcpy(fields.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+    fields.version = TABLE_FILE_VERSION;
+    fields.byteOrder = FILE_BYTE_ORDER;
+    fields.slotBytes = sizeof(slot_t);
+    fields.reserved = 0;
+    fields.count = count;
+
+    memset(header, 0, sizeof(header));
+    memcpy(header, &fields, sizeof(fields));
+
+    isWritten = false;
+    if ((file = fopen(temporary, "wb")) != NULL)
+    {
+        isWritten = fwrite(header, sizeof(header), 1, file) == 1;
+
+        // slots are atomic so are loaded into plain words to be written
+        for (i = 0; isWritten && i < count; i += FILE_CHUNK_SLOTS)
+        {
+            for (j = 0; j < FILE_CHUNK_SLOTS && i + j < count; j += 1)
+            {
+                words[2 * j] = atomic_load_explicit(&table->slots[i + j].check,
+                                                    memory_order_relaxed);
+                words[(2 * j) + 1] =
+                    atomic_load_explicit(&table->slots[i + j].data,
+                                         memory_order_relaxed);
+            }
+            isWritten = fwrite(words, sizeof(uint64_t) * 2, j, file) == j;
+        }
+
+        isWritten = fclose(file) == 0 && isWritten;
+        isWritten = isWritten && rename(temporary, path) == 0;
+        if (!isWritten)
+        {
+            remove(temporary);
+        }
+    }
+
+    free(words);
+    free(temporary);
+
+    return isWritten;
+}
+
+
+/*
+@context
+    * Removes every entry from `table`.
+    * Must not be called while another thread uses `table`.
+
+@parameters
+    * table
+        * Transposition table to clear.
+*/
+void clearTable(table_t *table)
+{
+    uint32_t i;
+
+    for (i = 0; i <= table->mask; i += 1)
+    {
+        atomic_init(&table->slots[i].check, 0);
+        atomic_init(&table->slots[i].data, 0);
+    }
+}
+
+
+/*
+@context
+    * Finds the entry of the state identified by `key`.
+    * Safe to call while other threads store entries.
+
+@parameters
+    * table
+        * Transposition table to search.
+    * key
+        * Key of the state to find.
+    * entry
+        * Set to the found entry.
+        * Unchanged if no entry found.
+
+@return
+    * Indicates if an entry for `key` was found.
+*/
+bool probeTable(table_t *table,
+                uint64_t key,
+                entry_t *entry)
+{
+    return loadSlot(&table->slots[key & table->mask], key, entry);
+}
+
+
+/*
+@context
+    * Stores the `entry` of the state identified by `key`.
+    * Only replaces an entry of the same state if `entry` is at least as deep.
+    * Safe to call while other threads probe and store entries.
+
+@parameters
+    * table
+        * Transposition table to store in.
+    * key
+        * Key of the state to store.
+    * entry
+        * Score, depth, bound and best move of the state.
+*/
+void storeTable(table_t *table,
+                uint64_t key,
+                entry_t  entry)
+{
+    slot_t *slot;
+    entry_t stored;
+    uint64_t data;
+
+    slot = &table->slots[key & table->mask];
+    if (loadSlot(slot, key, &stored) && stored.depth > entry.depth)
+    {
+        return;
+    }
+
+    data = packEntry(entry);
+    atomic_store_explicit(&slot->check, key ^ data, memory_order_relaxed);
+    atomic_store_explicit(&slot->data, data, memory_order_relaxed);
+}
+
+
+/* ------------------------------- END PUBLIC ------------------------------- */
+/* ----------------------------- START  PRIVATE ----------------------------- */
+
+
+/*
+@context
+    * Packs `entry` into the data of a used slot.
+
+@parameters
+    * entry
+        * Entry to pack.
+
+@return
+    * Data of the slot.
+*/
+static uint64_t packEntry(entry_t entry)
+{
+    return ((uint64_t)(uint32_t)entry.score << 32)
+        | DATA_USED
+        | ((uint64_t)entry.depth << 16)
+        | ((uint64_t)entry.bound << 8)
+        | entry.move;
+}
+
+
+/*
+@context
+    * Unpacks the entry within the data of a used slot.
+
+@parameters
+    * data
+        * Data of the slot.
+
+@return
+    * Entry of the slot.
+*/
+static entry_t unpackEntry(uint64_t data)
+{
+    entry_t entry;
+
+    entry.score = (score_t)(uint32_t)(data >> 32);
+    entry.depth = (uint8_t)(data >> 16);
+    entry.bound = (uint8_t)(data >> 8);
+    entry.move = (uint8_t)data;
+
+    return entry;
+}
+
+
+/*
+@context
+    * Loads the entry of `slot` if it is of the state identified by `key`.
+
+@parameters
+    * slot
+        * Slot to load.
+    * key
+        * Key of the state to find.
+    * entry
+        * Set to the entry of `slot` if found.
+
+@return
+    * Indicates if `slot` holds an entry for `key`.
+*/
+static bool loadSlot(slot_t   *slot,
+                     uint64_t  key,
+                     entry_t  *entry)
+{
+    uint64_t check, data;
+
+    data = atomic_load_explicit(&slot->data, memory_order_relaxed);
+    check = atomic_load_explicit(&slot->check, memory_order_relaxed);
+
+    if (!(data & DATA_USED) || (check ^ data) != key)
+    {
+        return false;
+    }
+
+    *entry = unpackEntry(data);
+    return true;
+}
+
+
+/*
+@context
+    * Determines if `header` is the start of a table file which can be loaded
+      - the same version and byte order with every slot it counts.
+
+@parameters
+    * header
+        * Start of the file.
+    * bytes
+        * Size of the whole file.
+
+@return
+    * Indicates if the file can be loaded.
+*/
+static bool isValidHeader(const fileheader_t *header,
+                          size_t              bytes)
+{
+    uint64_t count;
+
+    count = header->count;
+
+    // slots are indexed by a 32-bit mask so at most 2^32 (a power of 2)
+    return memcmp(header->magic, FILE_MAGIC, sizeof(FILE_MAGIC)) == 0
+        && header->version == TABLE_FILE_VERSION
+        && header->byteOrder == FILE_BYTE_ORDER
+        && header->slotBytes == sizeof(slot_t)
+        && count > 0 && count <= ((uint64_t)1 << 32)
+        && (count & (count - 1)) == 0
+        && bytes == FILE_HEADER_BYTES + (count * sizeof(slot_t));
+}
+
+
+/* ------------------------------ END  PRIVATE ------------------------------ */
@@ -0,0 +1,64 @@
+/*
+@context
+    * Provides a transposition table to store the scores of searched states.
+    * States are identified by a 64-bit key (Zobrist hash of the board).
+    * Each entry stores the score, how many moves deep it was searched and if
+      the score is exact or only a lower or upper bound on the real score.
+    * The table has a fixed number of entries where a new entry replaces the
+      entry at its index unless that is a deeper entry of the same state.
+    * Entries can be probed and stored by many threads at once without locks.
+    * Tables can be saved to a file and loaded again by any later process.
+        * Files are a header (magic, version and number of entries) then the
+          entries exactly as kept in memory, so loading maps the file
+          (`mmap`) without reading or parsing it.
+        * `TABLE_FILE_VERSION` is increased whenever keys, scores or the
+          packing of entries change so old files are not loaded.
+*/
+
+
+#ifndef _TRANSPOSITION_H
+    #define _TRANSPOSITION_H
+
+    #include <stdbool.h>
+    #include <stdint.h>
+
+    #include "score.h"
+
+
+    // how the stored score of an entry relates to the real score of a state
+    static const uint8_t BOUND_EXACT = 0;
+    static const uint8_t BOUND_LOWER = 1;  // real score >= stored score
+    static const uint8_t BOUND_UPPER = 2;  // real score <= stored score
+
+    // version of the table files written by `saveTable`
+    static const uint32_t TABLE_FILE_VERSION = 1;
+
+
+    typedef struct
+    {
+        score_t score;
+        uint8_t depth;
+        uint8_t bound;
+        uint8_t move;
+    } entry_t;
+
+    typedef struct table_s table_t;
+
+
+    table_t *initTable(uint32_t size);
+    void freeTable(table_t *table);
+
+    table_t *loadTable(const char *path);
+    bool saveTable(table_t    *table,
+                   const char *path);
+
+    void clearTable(table_t *table);
+
+    bool probeTable(table_t *table,
+                    uint64_t key,
+                    entry_t *entry);
+    void storeTable(table_t *table,
+                    uint64_t key,
+                    entry_t  entry);
+
+#endif